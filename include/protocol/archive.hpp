@@ -0,0 +1,108 @@
+#pragma once
+
+#include "lattice_proof.hpp"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace protocol {
+
+// Location of one segment in an archive
+struct ArchiveSegment {
+    uint64_t offset;
+    uint64_t first_record;
+    uint32_t records;
+};
+
+// Append-only columnar archive of transcripts sharing one parameter header.
+//
+// Records are grouped into segments. Each segment stores its u, c and z
+// columns separately: u bit-packed at bits(q) per coefficient, c as five
+// trits per byte, and z centered, zigzag-encoded and bit-packed at the
+// segment's widest value. An index of segment offsets is appended on close;
+// if it is missing (the writer died), segments are found by scanning.
+class ArchiveWriter {
+public:
+    // Creates path, or reopens an existing archive with the same parameters
+    ArchiveWriter(const std::string& path, const Parameters& params,
+                  uint32_t segment_records = 1024);
+    ~ArchiveWriter();
+
+    ArchiveWriter(const ArchiveWriter&) = delete;
+    ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+    void append(const Transcript& t);
+    void flush();  // writes any buffered records as a (short) segment
+    void close();  // flushes and writes the index
+
+    uint64_t size() const { return records_; }
+
+private:
+    void write_segment();
+
+    Parameters params_;
+    uint32_t segment_records_;
+    std::string path_;
+    std::ofstream out_;
+    uint64_t offset_;
+    uint64_t records_;
+    std::vector<ArchiveSegment> index_;
+    std::vector<Transcript> pending_;
+    bool closed_;
+};
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+};
+
+// Read-only view of an archive, memory-mapped for random access.
+// Decoding produces vec_ZZ_p values, so callers must have the ZZ_p modulus set.
+class ArchiveReader {
+public:
+    explicit ArchiveReader(const std::string& path);
+
+    const Parameters& parameters() const { return params_; }
+    uint64_t size() const { return records_; }
+    const std::vector<ArchiveSegment>& segments() const { return index_; }
+
+    std::vector<Transcript> read_segment(size_t k) const;
+    Transcript read(uint64_t record) const;
+
+private:
+    MappedFile file_;
+    Parameters params_;
+    uint64_t records_;
+    std::vector<ArchiveSegment> index_;
+};
+
+struct ReplayReport {
+    uint64_t records = 0;
+    uint64_t accepted = 0;
+    std::vector<uint64_t> rejected;  // record numbers that failed verification
+    std::vector<ArchiveSegment> corrupt;  // segments that could not be decoded
+    double seconds = 0;
+};
+
+// Re-verify every archived transcript against proof, handing whole segments to
+// threads (0 = one per hardware thread). Each thread sets up its own ZZ_p context.
+// Records of a segment that fails to decode are listed under corrupt and
+// counted neither accepted nor rejected; other errors are rethrown after all
+// threads have stopped.
+ReplayReport replay_archive(const ArchiveReader& archive, const LatticeProof& proof,
+                            unsigned threads = 0);
+
+} // namespace protocol
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "lattice_proof.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace protocol {
+
+// One bit per input, set when that proof verified
+struct BatchVerifyResult {
+    size_t size = 0;
+    std::vector<uint64_t> bits;
+
+    bool accepted(size_t i) const { return (bits[i / 64] >> (i % 64)) & 1; }
+    size_t count() const;  // number of accepted proofs
+    bool all() const { return count() == size; }
+};
+
+// verify() for a single transcript, treating malformed input
+// (std::invalid_argument) as a rejection
+bool verify_transcript(const LatticeProof& proof, const Transcript& t);
+
+// Verify independent proofs on threads (0 = one per hardware thread; the
+// calling thread is one of them). Inputs are split into small chunks dealt
+// out to per-thread queues, and threads that run dry steal from the back of
+// the others', so fast early rejections do not leave cores idle. Each worker
+// installs its own ZZ_p context for proof's modulus (the caller's context is
+// left untouched) and runs its kernels serially (SerialKernelScope).
+// Verification draws no randomness, so NTL's RNG is unused.
+BatchVerifyResult verify_many(const LatticeProof& proof, const std::vector<Transcript>& transcripts,
+                              unsigned threads = 0);
+BatchVerifyResult verify_many(const LatticeProof& proof, const std::vector<NonInteractiveProof>& proofs,
+                              unsigned threads = 0);
+
+} // namespace protocol
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace protocol {
+
+// Little-endian byte buffer writer used by key files and archives
+class ByteWriter {
+public:
+    void put_u8(uint8_t v) { buf_.push_back(v); }
+    void put_u32(uint32_t v) { put_le(v, 4); }
+    void put_u64(uint64_t v) { put_le(v, 8); }
+    void put_f64(double v) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        put_u64(bits);
+    }
+    void put_bytes(const uint8_t* data, size_t len) { buf_.insert(buf_.end(), data, data + len); }
+    void put_tag(const char tag[4]) { put_bytes(reinterpret_cast<const uint8_t*>(tag), 4); }
+
+    const std::vector<uint8_t>& bytes() const { return buf_; }
+    std::vector<uint8_t>& bytes() { return buf_; }
+
+private:
+    void put_le(uint64_t v, int len) {
+        for (int i = 0; i < len; i++) {
+            buf_.push_back(static_cast<uint8_t>(v >> (8 * i)));
+        }
+    }
+
+    std::vector<uint8_t> buf_;
+};
+
+// Bounds-checked reader over a byte range; throws std::runtime_error on truncation
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size) : data_(data), size_(size), pos_(0) {}
+
+    uint8_t get_u8() { return static_cast<uint8_t>(get_le(1)); }
+    uint32_t get_u32() { return static_cast<uint32_t>(get_le(4)); }
+    uint64_t get_u64() { return get_le(8); }
+    double get_f64() {
+        uint64_t bits = get_u64();
+        double v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+    const uint8_t* get_bytes(size_t len) {
+        require(len);
+        const uint8_t* p = data_ + pos_;
+        pos_ += len;
+        return p;
+    }
+    void expect_tag(const char tag[4]) {
+        if (std::memcmp(get_bytes(4), tag, 4) != 0) {
+            throw std::runtime_error(std::string("Bad magic, expected ") + std::string(tag, 4));
+        }
+    }
+
+    size_t position() const { return pos_; }
+    size_t remaining() const { return size_ - pos_; }
+    void seek(size_t pos) {
+        if (pos > size_) throw std::runtime_error("Seek past end of data");
+        pos_ = pos;
+    }
+
+private:
+    void require(size_t len) const {
+        if (len > size_ - pos_) throw std::runtime_error("Unexpected end of data");
+    }
+    uint64_t get_le(int len) {
+        const uint8_t* p = get_bytes(len);
+        uint64_t v = 0;
+        for (int i = len - 1; i >= 0; i--) {
+            v = (v << 8) | p[i];
+        }
+        return v;
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_;
+};
+
+// LSB-first bit packing of fixed-width fields (width <= 64)
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out), acc_(0), fill_(0) {}
+
+    void put(uint64_t v, int width) {
+        while (width > 0) {
+            int take = std::min(width, 8 - fill_);
+            acc_ |= static_cast<unsigned>(v & ((1u << take) - 1)) << fill_;
+            v >>= take;
+            width -= take;
+            fill_ += take;
+            if (fill_ == 8) {
+                out_.push_back(static_cast<uint8_t>(acc_));
+                acc_ = 0;
+                fill_ = 0;
+            }
+        }
+    }
+
+    // Pad the final partial byte with zeros
+    void flush() {
+        if (fill_ > 0) {
+            out_.push_back(static_cast<uint8_t>(acc_));
+            acc_ = 0;
+            fill_ = 0;
+        }
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+    unsigned acc_;
+    int fill_;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size, uint64_t bit_offset = 0)
+        : data_(data), size_(size), pos_(bit_offset) {}
+
+    uint64_t get(int width) {
+        if (pos_ + width > 8 * static_cast<uint64_t>(size_)) {
+            throw std::runtime_error("Unexpected end of packed data");
+        }
+        uint64_t v = 0;
+        for (int done = 0; done < width;) {
+            uint64_t byte = data_[pos_ / 8] >> (pos_ % 8);
+            int take = std::min<int>(width - done, 8 - static_cast<int>(pos_ % 8));
+            v |= (byte & ((uint64_t(1) << take) - 1)) << done;
+            done += take;
+            pos_ += take;
+        }
+        return v;
+    }
+
+    uint64_t position() const { return pos_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    uint64_t pos_;
+};
+
+} // namespace protocol
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <NTL/vec_ZZ.h>
+#include <NTL/vec_ZZ_p.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace protocol {
+
+// Challenge with exactly weight() coefficients in {-1,1} and all others zero,
+// stored as an index list sorted ascending with matching signs
+struct SparseChallenge {
+    int length = 0;
+    std::vector<int32_t> index;
+    std::vector<int8_t> sign;
+
+    int weight() const { return static_cast<int>(index.size()); }
+    NTL::vec_ZZ to_dense() const;
+};
+
+// Digest of the public key (LatticeProof::key_digest) that Fiat-Shamir
+// challenges are bound to
+using ChallengeKey = std::array<uint8_t, 32>;
+
+// Sampling from the NTL RNG or deterministically from a seed via SHAKE256
+SparseChallenge sample_sparse_challenge(int length, int weight);
+SparseChallenge derive_sparse_challenge(const uint8_t* seed, size_t seed_len,
+                                        int length, int weight);
+
+// Same, with the key digest absorbed ahead of the seed when key is not null;
+// the protocol always passes its key, so a challenge depends on the
+// parameters and (A, t) as well as the commitment
+SparseChallenge derive_sparse_challenge(const ChallengeKey* key, const uint8_t* seed,
+                                        size_t seed_len, int length, int weight);
+
+// Same as derive_sparse_challenge on each of count equal-length seeds, hashed
+// together through the multi-buffer SHAKE256
+std::vector<SparseChallenge> derive_sparse_challenges(const uint8_t* const* seeds, size_t seed_len,
+                                                      size_t count, int length, int weight);
+std::vector<SparseChallenge> derive_sparse_challenges(const ChallengeKey* key, const uint8_t* const* seeds,
+                                                      size_t seed_len, size_t count, int length, int weight);
+
+// Fiat-Shamir challenge bound to a public key and a commitment
+SparseChallenge derive_sparse_challenge(const ChallengeKey& key, const NTL::vec_ZZ_p& u,
+                                        int length, int weight);
+
+// Bit-packed encoding: weight * (bits(length - 1) + 1) bits
+long encoded_challenge_bits(int length, int weight);
+std::vector<uint8_t> encode_challenge(const SparseChallenge& c);
+SparseChallenge decode_challenge(const std::vector<uint8_t>& bytes, int length, int weight);
+
+// Throws std::invalid_argument unless c is a well-formed challenge of the given shape
+void validate_challenge(const SparseChallenge& c, int length, int weight);
+
+} // namespace protocol
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <NTL/vec_ZZ_p.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace protocol {
+
+// High bits r >> d of each commitment coefficient r in [0, q)
+struct CompressedCommitment {
+    std::vector<uint64_t> high;
+};
+
+// SHAKE256 digest of the high bits, sent instead of them in non-interactive mode
+using CommitmentDigest = std::array<uint8_t, 32>;
+
+CompressedCommitment compress_commitment(const NTL::vec_ZZ_p& u, int drop_bits);
+CommitmentDigest commitment_digest(const CompressedCommitment& w1);
+
+// Digests of several commitments at once (multi-buffer when lengths agree)
+std::vector<CommitmentDigest> commitment_digests(const std::vector<CompressedCommitment>& w1s);
+
+// Size of the compressed commitment: n * (bits(q) - d) bits
+long compressed_commitment_bits(int n, const NTL::ZZ& q, int drop_bits);
+
+// Wire form of w1: the high bits packed LSB-first at bits(q) - d bits each,
+// (compressed_commitment_bits + 7) / 8 bytes in all, zero-padded. Decoding
+// throws std::invalid_argument unless the size matches n, the padding is zero
+// and every value is at most (q - 1) >> d; encoding checks the same range.
+std::vector<uint8_t> encode_commitment(const CompressedCommitment& w1, const NTL::ZZ& q, int drop_bits);
+CompressedCommitment decode_commitment(const std::vector<uint8_t>& bytes, int n,
+                                       const NTL::ZZ& q, int drop_bits);
+
+} // namespace protocol
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace protocol {
+
+// Keccak-f[1600] permutation (FIPS 202)
+void keccak_f1600(uint64_t state[25]);
+
+// Keccak-f[1600] on 4 or 8 states at once. States are lane-interleaved:
+// lanes[i * W + k] is lane i of state k. Runs on AVX2 / AVX-512F when the CPU
+// has them and falls back to one state at a time otherwise.
+void keccak_f1600_x4(uint64_t lanes[25 * 4]);
+void keccak_f1600_x8(uint64_t lanes[25 * 8]);
+
+// States the widest available permutation processes together (1, 4 or 8)
+int keccak_parallelism();
+
+// Incremental SHAKE128 / SHAKE256 extendable-output function
+class Shake {
+public:
+    explicit Shake(int security_bits = 256);  // 128 or 256
+
+    void absorb(const uint8_t* data, size_t len);
+    void squeeze(uint8_t* out, size_t len);  // the first call finalizes absorption
+
+private:
+    uint64_t state_[25];
+    size_t rate_;
+    size_t pos_;
+    bool squeezing_;
+};
+
+// count independent SHAKE instances advanced in lockstep through the
+// multi-buffer permutation. Each call absorbs (squeezes) len bytes into (out
+// of) every instance, so instance k yields exactly what a Shake fed the same
+// calls would.
+class ShakeMany {
+public:
+    ShakeMany(int security_bits, size_t count);  // 128 or 256
+
+    void absorb_shared(const uint8_t* data, size_t len);   // same bytes for all
+    void absorb(const uint8_t* const* data, size_t len);   // data[k] for instance k
+    void squeeze(uint8_t* const* out, size_t len);         // out[k] for instance k
+
+    size_t size() const { return count_; }
+    size_t rate() const { return rate_; }
+
+private:
+    uint64_t& lane(size_t k, size_t i);
+    void xor_bytes(size_t k, const uint8_t* data, size_t len);
+    void permute();
+    void finalize();
+
+    std::vector<uint64_t> lanes_;  // groups of 8 lane-interleaved states
+    size_t count_;
+    size_t rate_;
+    size_t pos_;
+    bool squeezing_;
+};
+
+void shake128(uint8_t* out, size_t outlen, const uint8_t* in, size_t inlen);
+void shake256(uint8_t* out, size_t outlen, const uint8_t* in, size_t inlen);
+
+// One-shot hashing of count equal-length inputs
+void shake128_many(uint8_t* const* out, size_t outlen, const uint8_t* const* in, size_t inlen,
+                   size_t count);
+void shake256_many(uint8_t* const* out, size_t outlen, const uint8_t* const* in, size_t inlen,
+                   size_t count);
+
+} // namespace protocol
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "pages.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace protocol {
+
+// Row-major copy of a matrix mod q with word-sized entries (requires q < 2^32).
+// Large matrices are page-mapped, on huge pages when enabled (see pages.hpp).
+struct NativeMatrix {
+    long rows = 0;
+    long cols = 0;
+    uint32_t q = 0;
+    std::vector<uint32_t, PageAllocator<uint32_t>> data;
+
+    const uint32_t* row(long i) const { return data.data() + i * cols; }
+};
+
+// Bitsliced ternary vector: bit j of pos (neg) is set when v[j] == 1 (-1)
+struct PackedTernary {
+    long length = 0;
+    std::vector<uint64_t> pos;
+    std::vector<uint64_t> neg;
+};
+
+PackedTernary pack_ternary(const int8_t* v, long length);
+
+// Same bits into caller buffers of (length + 63) / 64 words each
+void pack_ternary(const int8_t* v, long length, uint64_t* pos, uint64_t* neg);
+
+// out = M * v mod q for ternary v, using only additions and subtractions
+void ternary_matvec(const NativeMatrix& M, const PackedTernary& v, uint32_t* out);
+void ternary_matvec(const NativeMatrix& M, const uint64_t* pos, const uint64_t* neg,
+                    uint32_t* out);
+
+// out = M * v mod q for v whose only nonzero entries are coeff[k] in {-1,0,1}
+// at column index[k], touching weight columns of M
+void sparse_matvec(const NativeMatrix& M, const int32_t* index, const int8_t* coeff,
+                   long weight, uint32_t* out);
+
+// out = M * v mod q for small signed v, using 32x32->64 bit multiplies and
+// reducing the accumulator only when it could overflow
+void small_matvec(const NativeMatrix& M, const int32_t* v, uint32_t* out);
+
+// out += M[:, first, first + count) * v mod q, with out already reduced; lets a
+// product be built up from column blocks of v as they become available
+void small_matvec_columns(const NativeMatrix& M, long first, const int32_t* v, long count,
+                          uint32_t* out);
+
+// small_matvec for count vectors at once (v and out hold them back to back),
+// reading each row of M once for the whole batch
+void small_matvec_batch(const NativeMatrix& M, const int32_t* v, long count, uint32_t* out);
+
+// Variants of small_matvec_batch with identical results; the autotuner picks
+// among them per machine and shape (see tuner.hpp)
+
+// Four rows per pass, so each vector entry loaded is used four times
+void small_matvec_blocked(const NativeMatrix& M, const int32_t* v, long count, uint32_t* out);
+
+// AVX2, four 64-bit accumulators per row; requires avx2_available() and a
+// modulus the kernel supports: q < 2^31, or any pseudo-Mersenne or Solinas q
+// below 2^32 (see reduction.hpp), whose products are folded instead
+bool avx2_available();
+bool avx2_supports_modulus(uint32_t q);
+void small_matvec_avx2(const NativeMatrix& M, const int32_t* v, long count, uint32_t* out);
+
+// Native matrix for the FMA kernel: centered entries as doubles, rows grouped
+// in panels of kPanelRows stored column by column (zero-padded at the end)
+const long kPanelRows = 16;
+
+struct PanelMatrix {
+    long rows = 0;
+    long cols = 0;
+    uint32_t q = 0;
+    std::vector<double, PageAllocator<double>> data;
+};
+
+PanelMatrix to_panels(const NativeMatrix& M);
+
+// AVX2 with FMA (AVX-512 is used when present)
+bool fma_available();
+
+// Terms |a| <= q/2 times |v| <= max_abs that can be summed exactly in a
+// double (below 2^53); 0 when not even one product is exact
+long fma_exact_terms(uint32_t q, int64_t max_abs);
+
+// small_matvec_batch as a blocked double-precision GEMM: panel blocks times
+// groups of four vectors on FMA units, with one reduction per output whenever
+// fma_exact_terms covers a whole row. Throws std::invalid_argument if not even
+// single products are exact.
+void fma_matvec(const PanelMatrix& P, const int32_t* v, long count, uint32_t* out);
+
+// Marks the calling thread as one worker of an already parallel caller
+// (batch verification, archive replay, load generation) until destroyed;
+// nests. Inside it, kernels that would start threads of their own (the
+// threaded matvec, RNS channels) run on the calling thread instead, so a pool
+// of k workers keeps k threads busy rather than k times the kernel's.
+class SerialKernelScope {
+public:
+    SerialKernelScope();
+    ~SerialKernelScope();
+
+    SerialKernelScope(const SerialKernelScope&) = delete;
+    SerialKernelScope& operator=(const SerialKernelScope&) = delete;
+};
+
+bool in_serial_kernel_scope();
+
+// Rows split evenly across threads (one inside a SerialKernelScope)
+void small_matvec_threaded(const NativeMatrix& M, const int32_t* v, long count, uint32_t* out,
+                           unsigned threads);
+
+} // namespace protocol
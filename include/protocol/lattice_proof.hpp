@@ -1,15 +1,64 @@
 #pragma once
 
+#include "challenge.hpp"
+#include "compression.hpp"
+#include "memory.hpp"
+#include "numa.hpp"
 #include "parameters.hpp"
+#include "rns.hpp"
+#include "serialization.hpp"
+#include "span.hpp"
+#include "tuner.hpp"
 #include "utils.hpp"
 #include <NTL/mat_ZZ_p.h>
 #include <NTL/vec_ZZ_p.h>
+#include <array>
 
 namespace protocol {
 
+// One interactive proof transcript; z is reduced to [0, q)
+struct Transcript {
+    NTL::vec_ZZ_p u;
+    NTL::vec_ZZ challenge;
+    NTL::vec_ZZ z;
+};
+
+// Non-interactive proof: digest of the compressed commitment and the response,
+// with the challenge derived from the digest
+struct NonInteractiveProof {
+    CommitmentDigest digest;
+    NTL::vec_ZZ z;
+};
+
+// Prover-side rejection sampling counters
+struct RejectionStats {
+    uint64_t attempts = 0;      // candidate responses tested
+    uint64_t accepted = 0;      // candidates released
+    uint64_t max_attempts = 0;  // most attempts spent on a single accepted response
+    double seconds = 0;         // total time spent producing responses
+    double retry_seconds = 0;   // part of seconds spent after a first rejection
+
+    double abort_rate() const {
+        return attempts ? static_cast<double>(attempts - accepted) / attempts : 0.0;
+    }
+};
+
+class Workspace;
+
 class LatticeProof {
+    friend class StreamingVerifier;
+
 public:
     explicit LatticeProof(const Parameters& params);
+
+    // Fresh secret with A expanded from a public seed (see expand_matrix)
+    LatticeProof(const Parameters& params, const MatrixSeed& seed);
+
+    // Restore a key from a key file positioned just after read_key_parameters
+    LatticeProof(const Parameters& params, ByteReader& key);
+
+    // Write a key file (header, A and s) that the constructor above can restore
+    void save_key(ByteWriter& out) const;
     
     // Protocol operations
     NTL::vec_ZZ_p commit();
@@ -17,20 +66,124 @@ public:
     bool verify(const NTL::vec_ZZ_p& u, 
                const NTL::vec_ZZ& challenge, 
                const NTL::vec_ZZ& z) const;
+
+    // Responses with early abort: false means z was withheld and the mask is
+    // spent, so the caller must commit() again. The test runs in machine
+    // integers and rejects any z that would fail verify()'s norm check, plus,
+    // when params.rejection_sampling(), any z with a challenged coordinate
+    // outside params.rejection_bound(). Challenges must be ternary.
+    bool try_respond(const NTL::vec_ZZ& challenge, NTL::vec_ZZ& z);
+    bool try_respond(const SparseChallenge& challenge, NTL::vec_ZZ& z);
+
+    // Sparse fixed-weight challenges (requires params.challenge_weight() > 0)
+    NTL::vec_ZZ respond(const SparseChallenge& challenge);
+    bool verify(const NTL::vec_ZZ_p& u,
+               const SparseChallenge& challenge,
+               const NTL::vec_ZZ& z) const;
+
+    // Compressed commitments (requires params.commitment_drop_bits() > 0)
+    CompressedCommitment commit_compressed();
+    bool verify(const CompressedCommitment& w1,
+               const NTL::vec_ZZ& challenge,
+               const NTL::vec_ZZ& z) const;
+    bool verify(const CompressedCommitment& w1,
+               const SparseChallenge& challenge,
+               const NTL::vec_ZZ& z) const;
+
+    // Non-interactive mode (also requires params.challenge_weight() > 0).
+    // With rejection sampling prove() retries internally, drawing candidate
+    // masks in batches committed with one matrix pass.
+    NonInteractiveProof prove();
+    bool verify(const NonInteractiveProof& proof) const;
+
+    // Allocation-free overloads (q < 2^32; see workspace.hpp). Vectors are
+    // caller buffers: u of n residues, challenges of m entries in {-1, 0, 1}
+    // and z of m centered integers. The mask of an open commitment lives in
+    // the workspace, so threads with their own workspaces can share one
+    // LatticeProof; rejection statistics go to the workspace as well.
+    void commit(Workspace& ws, Span<uint32_t> u) const;
+    void respond(Workspace& ws, Span<const int8_t> challenge, Span<int32_t> z) const;
+    void respond(Workspace& ws, const SparseChallenge& challenge, Span<int32_t> z) const;
+    bool try_respond(Workspace& ws, Span<const int8_t> challenge, Span<int32_t> z) const;
+    bool try_respond(Workspace& ws, const SparseChallenge& challenge, Span<int32_t> z) const;
+    bool verify(Workspace& ws, Span<const uint32_t> u, Span<const int8_t> challenge,
+                Span<const int32_t> z) const;
+    bool verify(Workspace& ws, Span<const uint32_t> u, const SparseChallenge& challenge,
+                Span<const int32_t> z) const;
     
     // Getters
-    NTL::mat_ZZ_p getA() const { return A_; }
-    NTL::vec_ZZ_p getT() const { return t_; }
+    const Parameters& parameters() const { return params_; }
+    const RejectionStats& rejection_stats() const { return stats_; }
+    MemoryFootprint footprint() const;
+    void reset_rejection_stats() { stats_ = RejectionStats(); }
+
+    // SHAKE256 of the parameters and public key (A, t)
+    const std::array<uint8_t, 32>& key_digest() const { return key_digest_; }
+    const NTL::mat_ZZ_p& getA() const { return A_; }
+    const NTL::vec_ZZ_p& getT() const { return t_; }
     
     // Static methods
     static NTL::vec_ZZ generate_challenge(int length);
+    static void generate_challenge(Span<int8_t> out);
+    static SparseChallenge generate_sparse_challenge(int length, int weight);
 
 private:
+    void init_public_key();
+
+    // Commitments Ay for several masks, sharing one pass over A where possible
+    std::vector<NTL::vec_ZZ_p> commit_batch(const std::vector<NTL::vec_ZZ>& ys) const;
+
+    // Early-abort test on z = y + c*s for ternary c; sets z (reduced mod q) on success
+    bool accept_response(const NTL::vec_ZZ& y, const std::vector<int8_t>& c,
+                         long norm_bound, NTL::vec_ZZ& z) const;
+    void record_attempts(uint64_t attempts, double seconds, double retry_seconds);
+
+    // Dimension and norm checks on the response
+    bool check_response(const NTL::vec_ZZ& challenge, const NTL::vec_ZZ& z) const;
+    bool check_response(const SparseChallenge& challenge, const NTL::vec_ZZ& z) const;
+
+    // A(c*s), the part of Az that the secret contributes
+    NTL::vec_ZZ_p challenge_product(const NTL::vec_ZZ& challenge) const;
+    NTL::vec_ZZ_p challenge_product(const SparseChallenge& challenge) const;
+
+    // Az - A(c*s), which equals u for an honest transcript
+    NTL::vec_ZZ_p recompute_commitment(const NTL::vec_ZZ& challenge, const NTL::vec_ZZ& z) const;
+    NTL::vec_ZZ_p recompute_commitment(const SparseChallenge& challenge, const NTL::vec_ZZ& z) const;
+    NTL::vec_ZZ_p recompute_native(const std::vector<uint32_t>& ct, const NTL::vec_ZZ& z) const;
+
+    void check_compression_enabled() const;
+
+    // Shared checks and steps of the allocation-free overloads
+    void check_workspace(const Workspace& ws) const;
+    bool accept_span(Workspace& ws, const int8_t* c, long norm_bound, Span<int32_t> z) const;
+    bool matches_commitment(Workspace& ws, Span<const uint32_t> u, Span<const int32_t> z) const;
+
+    // Word-sized A for the calling thread: its node's replica when A is
+    // replicated across NUMA nodes
+    const NativeMatrix& native_matrix() const;
+    const PanelMatrix* panel_matrix() const;  // same, for the Fma panels
+
     const Parameters& params_;
     NTL::mat_ZZ_p A_;  // Public matrix
     NTL::vec_ZZ s_;    // Secret vector
     NTL::vec_ZZ y_;    // Random vector for commitment
     NTL::vec_ZZ_p t_;  // Public value (As)
+
+    // Word-sized copies used by the native kernels when q < 2^32
+    bool native_ = false;
+    NativeMatrix A_native_;
+    std::vector<NativeMatrix> A_replicas_;  // one per NUMA node when enabled
+    KernelPlan plan_;  // autotuned strategy for small_matvec-shaped products
+    PanelMatrix A_panels_;  // double-precision copy, only for the Fma kernel
+    std::vector<PanelMatrix> A_panel_replicas_;  // replaces A_panels_ alongside A_replicas_
+    std::vector<int8_t> s_ternary_;
+
+    // Residue channels used instead when q is too wide for the native kernels
+    bool rns_ = false;
+    RnsMatrix A_rns_;
+
+    RejectionStats stats_;
+    std::array<uint8_t, 32> key_digest_{};
 };
 
 } // namespace protocol
\ No newline at end of file
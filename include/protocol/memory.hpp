@@ -0,0 +1,81 @@
+#pragma once
+
+#include <NTL/ZZ.h>
+#include <NTL/mat_ZZ_p.h>
+#include <NTL/vec_ZZ.h>
+#include <NTL/vec_ZZ_p.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace protocol {
+
+// Estimated heap bytes owned by NTL objects, following NTL's layout: each
+// nonzero ZZ (and every ZZ_p, which is preallocated to the modulus size) is a
+// separate block of a two-word header plus 64-bit limbs, and vectors add one
+// array block. Each block is charged malloc's two-word overhead.
+size_t heap_bytes(const NTL::ZZ& v);
+size_t heap_bytes(const NTL::vec_ZZ& v);
+size_t heap_bytes(const NTL::vec_ZZ_p& v, const NTL::ZZ& q);
+size_t heap_bytes(const NTL::mat_ZZ_p& M, const NTL::ZZ& q);
+
+template <class T, class Alloc>
+size_t heap_bytes(const std::vector<T, Alloc>& v) {
+    return v.capacity() * sizeof(T);
+}
+
+// Per-object memory of a LatticeProof, by component
+struct MemoryFootprint {
+    size_t object = 0;      // sizeof(LatticeProof)
+    size_t matrix = 0;      // A in NTL form
+    size_t public_key = 0;  // t = As
+    size_t secret = 0;      // s and its packed copy
+    size_t session = 0;     // commitment mask and other per-round state
+    size_t kernels = 0;     // word-sized, per-node and RNS copies of A for the fast paths
+
+    size_t total() const { return object + matrix + public_key + secret + session + kernels; }
+};
+
+// Allocation accounting. Library entry points tag the calling thread with
+// the protocol phase they run; the counting hook (the lattice_zkp_alloc_hook
+// object library, which interposes malloc) charges each allocation to the
+// tagged phase. Without the hook linked in, all counters stay zero.
+enum class AllocPhase { Other, Setup, Commit, Respond, Verify };
+const int kAllocPhases = 5;
+
+const char* phase_name(AllocPhase phase);
+
+struct AllocCounters {
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    uint64_t bytes_allocated = 0;
+    uint64_t bytes_freed = 0;
+
+    AllocCounters operator-(const AllocCounters& other) const {
+        return {allocations - other.allocations, frees - other.frees,
+                bytes_allocated - other.bytes_allocated, bytes_freed - other.bytes_freed};
+    }
+};
+
+// Tags allocations on this thread with phase until destroyed (nests)
+class AllocPhaseScope {
+public:
+    explicit AllocPhaseScope(AllocPhase phase);
+    ~AllocPhaseScope();
+
+    AllocPhaseScope(const AllocPhaseScope&) = delete;
+    AllocPhaseScope& operator=(const AllocPhaseScope&) = delete;
+
+private:
+    AllocPhase saved_;
+};
+
+bool alloc_hook_installed();
+AllocCounters alloc_counters(AllocPhase phase);
+void reset_alloc_counters();
+
+// Called by the hook for every block (usable size)
+void record_allocation(size_t bytes);
+void record_free(size_t bytes);
+
+} // namespace protocol
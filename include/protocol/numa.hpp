@@ -0,0 +1,32 @@
+#pragma once
+
+#include "kernels.hpp"
+#include <vector>
+
+namespace protocol {
+
+// CPUs of each NUMA node, read from /sys/devices/system/node. Machines
+// without that information are treated as one node holding every CPU.
+struct NumaTopology {
+    std::vector<std::vector<int>> node_cpus;
+
+    int nodes() const { return static_cast<int>(node_cpus.size()); }
+    int node_of_cpu(int cpu) const;  // 0 if cpu is unknown
+};
+
+const NumaTopology& numa_topology();
+
+// Node of the CPU the calling thread is running on
+int current_numa_node();
+
+// One copy of M per node of topology, each built by a thread pinned to that
+// node's CPUs so first-touch allocation places its pages locally. Empty for
+// single-node topologies, where replicas would only duplicate M.
+std::vector<NativeMatrix> replicate_per_node(const NativeMatrix& M,
+                                             const NumaTopology& topology = numa_topology());
+
+// Same for the Fma kernel's panels of M, each converted on its node
+std::vector<PanelMatrix> replicate_panels_per_node(const NativeMatrix& M,
+                                                   const NumaTopology& topology = numa_topology());
+
+} // namespace protocol
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace protocol {
+
+// Blocks of at least this size are mapped directly, 2 MB aligned, so the
+// kernel can back them with huge pages
+const size_t kLargePageBytes = size_t(1) << 21;
+
+// Process-wide placement of the word-sized matrix copies. huge_pages asks for
+// 2 MB pages (hugetlbfs if reserved, else transparent huge pages);
+// numa_replicas keeps one copy of A (and of its Fma panels) per NUMA node.
+// Defaults come from LATTICE_ZKP_HUGEPAGES and LATTICE_ZKP_NUMA_REPLICAS
+// (set to 1 to enable).
+struct MatrixPlacement {
+    bool huge_pages = false;
+    bool numa_replicas = false;
+};
+
+MatrixPlacement matrix_placement();
+void set_matrix_placement(const MatrixPlacement& placement);
+
+// Allocation used by PageAllocator: small blocks come from operator new,
+// large ones from mmap (with huge pages when enabled). free_pages must be
+// given the same size.
+void* allocate_pages(size_t bytes);
+void free_pages(void* p, size_t bytes);
+
+template <class T>
+struct PageAllocator {
+    using value_type = T;
+
+    PageAllocator() = default;
+    template <class U>
+    PageAllocator(const PageAllocator<U>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(allocate_pages(n * sizeof(T))); }
+    void deallocate(T* p, size_t n) { free_pages(p, n * sizeof(T)); }
+
+    template <class U>
+    bool operator==(const PageAllocator<U>&) const { return true; }
+    template <class U>
+    bool operator!=(const PageAllocator<U>&) const { return false; }
+};
+
+} // namespace protocol
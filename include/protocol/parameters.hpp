@@ -1,5 +1,6 @@
 #pragma once
 
+#include "reduction.hpp"
 #include <NTL/ZZ.h>
 #include <string>
 
@@ -10,10 +11,30 @@ public:
     Parameters(int n, int m, const NTL::ZZ& q, 
                int y_range = 10, int s_range = 1, 
                double safety_factor = 10.0,
-               double sigma = 1.5);  // Added sigma parameter
+               double sigma = 1.5,  // Added sigma parameter
+               int challenge_weight = 0,  // 0 selects dense ternary challenges
+               int commitment_drop_bits = 0,  // 0 sends commitments uncompressed
+               double rejection_repetitions = 0.0);  // 0 disables rejection sampling
     
     static Parameters DefaultParams();
     static Parameters HighSecurityParams();
+
+    // Rejection sampling parameters with y_range chosen so the prover expects
+    // at most `repetitions` attempts per accepted response
+    static Parameters RejectionSamplingParams(int n, int m, const NTL::ZZ& q,
+                                              double repetitions = 3.0,
+                                              int challenge_weight = 0);
+
+    // Opt-in to a modulus chosen for cheap reduction: the largest prime
+    // 2^bits - c (smallest c) for PseudoMersenne, or 2^bits - 2^j + 1
+    // (smallest j > 1) for Solinas. Native kernels fold products with it.
+    static NTL::ZZ special_prime(int bits, ModulusForm form = ModulusForm::PseudoMersenne);
+    static Parameters SpecialModulusParams(int n, int m, int bits,
+                                           ModulusForm form = ModulusForm::PseudoMersenne);
+
+    // Smallest y_range giving at most `repetitions` expected attempts when
+    // `coeffs` coordinates of z are tested against y_range - s_range
+    static int rejection_y_range(int coeffs, int s_range, double repetitions);
     
     // Getters
     int n() const { return n_; }
@@ -23,8 +44,23 @@ public:
     int s_range() const { return s_range_; }
     double safety_factor() const { return safety_factor_; }
     double sigma() const { return sigma_; }  // Added getter for sigma
+    int challenge_weight() const { return challenge_weight_; }
+    int commitment_drop_bits() const { return commitment_drop_bits_; }
+    double rejection_repetitions() const { return rejection_repetitions_; }
+    bool rejection_sampling() const { return rejection_repetitions_ > 0; }
+
+    // Shape of q as seen by the reduction kernels; Generic above 63 bits
+    ModulusForm modulus_form() const;
+
+    // Largest |z_j| the prover releases under rejection sampling
+    int rejection_bound() const { return y_range_ - s_range_; }
+
+    // Expected attempts per accepted response for the current y_range
+    double expected_repetitions() const;
     
     bool validate() const;
+    bool operator==(const Parameters& other) const;
+    bool operator!=(const Parameters& other) const { return !(*this == other); }
     std::string toString() const;
 
 private:
@@ -35,6 +71,9 @@ private:
     int s_range_;       // range for ternary sampling
     double safety_factor_; // safety factor for norm bound
     double sigma_;      // Gaussian parameter
+    int challenge_weight_; // nonzeros in sparse challenges (0 = dense)
+    int commitment_drop_bits_; // low bits dropped from compressed commitments
+    double rejection_repetitions_; // target expected attempts (0 = no rejection)
 };
 
 } // namespace protocol
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+
+namespace protocol {
+
+// Moduli whose reduction needs no division. Pseudo-Mersenne: q = 2^k - c with
+// c < 2^(k/2), so 2^k = c mod q and the high part of x folds down with one
+// small multiply. Solinas: q = 2^k - 2^j + 1 with 1 < j < k, where the same
+// fold multiplies by 2^j - 1, a shift and a subtraction.
+enum class ModulusForm { Generic, PseudoMersenne, Solinas };
+
+const char* modulus_form_name(ModulusForm form);
+
+// Shape of q (at most 63 bits): sets k and c with q = 2^k - c when q is not
+// Generic; for Solinas c + 1 = 2^j
+ModulusForm classify_modulus(uint64_t q, int& k, uint64_t& c);
+
+// x mod q for a word-sized modulus (q < 2^32), by folding when q has a special
+// form and by division otherwise
+class Reducer {
+public:
+    explicit Reducer(uint32_t q);
+
+    ModulusForm form() const { return form_; }
+    bool special() const { return form_ != ModulusForm::Generic; }
+    uint32_t q() const { return q_; }
+    int k() const { return k_; }
+    uint32_t c() const { return static_cast<uint32_t>(c_); }
+    int shift() const { return shift_; }  // j for Solinas moduli, else 0
+
+    // One fold: a value congruent to x, below 2^k * (c + 1) when x < 2^(2k)
+    uint64_t fold(uint64_t x) const {
+        const uint64_t hi = x >> k_;
+        const uint64_t lo = x & mask_;
+        return shift_ ? lo + (hi << shift_) - hi : lo + hi * c_;
+    }
+
+    uint32_t reduce(uint64_t x) const {
+        if (form_ == ModulusForm::Generic) {
+            return static_cast<uint32_t>(x % q_);
+        }
+        while (x >> k_) {
+            x = fold(x);
+        }
+        return static_cast<uint32_t>(x >= q_ ? x - q_ : x);
+    }
+
+    uint32_t reduce_signed(int64_t x) const {
+        if (x >= 0) {
+            return reduce(static_cast<uint64_t>(x));
+        }
+        const uint32_t r = reduce(0 - static_cast<uint64_t>(x));
+        return r ? q_ - r : 0;
+    }
+
+private:
+    uint32_t q_;
+    ModulusForm form_;
+    int k_ = 0;
+    uint64_t c_ = 0;
+    int shift_ = 0;
+    uint64_t mask_ = 0;
+};
+
+} // namespace protocol
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "parameters.hpp"
+#include "span.hpp"
+#include <NTL/vec_ZZ.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace protocol {
+
+// Entropy coder for responses z, for archives and slow links. Coefficients of
+// an honest z follow a distribution fixed by the parameters (y uniform in
+// [-y_range, y_range] plus the ternary c*s term), so a static table derived
+// from Parameters codes them close to their entropy without sending a model.
+// Values outside [-bound(), bound()] are escaped and stored whole, so any z
+// round-trips.
+//
+// The coder is rANS with 8 interleaved 32-bit states and 16-bit
+// renormalization: lane k codes coefficients k, k + 8, ..., and decoding
+// steps all lanes at once with AVX2 when the CPU has it. Stream: varint
+// escape count, escaped residues at NumBytes(q) bytes each, then the final
+// lane states and renormalization words as little-endian 16-bit words.
+// Malformed streams throw std::runtime_error.
+class ResponseCodec {
+public:
+    static constexpr int kLanes = 8;
+
+    explicit ResponseCodec(const Parameters& params);
+
+    // z is coded mod q; decoding returns centered coefficients in (-q/2, q/2],
+    // as receive_response does, which verify() treats the same as residues
+    std::vector<uint8_t> encode(const NTL::vec_ZZ& z) const;
+    NTL::vec_ZZ decode(const uint8_t* data, size_t size) const;
+
+    // Word-sized forms (q < 2^32)
+    std::vector<uint8_t> encode(Span<const int32_t> z) const;
+    void decode(const uint8_t* data, size_t size, Span<int32_t> z) const;
+
+    // One lane at a time; same results as decode, for reference and testing
+    void decode_scalar(const uint8_t* data, size_t size, Span<int32_t> z) const;
+
+    long bound() const { return bound_; }
+    int scale_bits() const { return scale_bits_; }
+
+    // Shannon entropy of a whole response under the model, in bits
+    double entropy_bits() const { return entropy_bits_; }
+
+private:
+    struct Layout {
+        size_t escapes;
+        const uint8_t* escape_data;
+        const uint8_t* words;
+        size_t word_count;
+    };
+
+    std::vector<uint8_t> finish(const std::vector<uint16_t>& symbols,
+                                const std::vector<uint8_t>& escapes, size_t escape_count) const;
+    Layout parse(const uint8_t* data, size_t size) const;
+    void decode_values(const Layout& layout, int32_t* out, bool vectorized) const;
+    void decode_words(const uint8_t* data, size_t size, Span<int32_t> z, bool vectorized) const;
+    void check_native() const;
+
+    long m_;
+    NTL::ZZ q_;
+    long width_;  // bytes per escaped residue
+    long bound_;
+    int scale_bits_;
+    double entropy_bits_;
+
+    // Encoder: frequency and cumulative start per symbol (escape last)
+    std::vector<uint32_t> freq_;
+    std::vector<uint32_t> start_;
+
+    // Decoder, per slot: coefficient (kEscape for the escape symbol), and
+    // frequency | (slot - start) << 16 of its symbol
+    std::vector<int32_t> slot_value_;
+    std::vector<uint32_t> slot_step_;
+};
+
+} // namespace protocol
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <NTL/vec_ZZ.h>
+#include <NTL/vec_ZZ_p.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace protocol {
+
+// Message read from a ring; data points into the ring and stays valid until
+// the next release()
+struct RingRecord {
+    uint32_t type = 0;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+// Single-producer, single-consumer message ring in POSIX shared memory, for
+// prover and verifier processes on the same host.
+//
+// Messages are written into ring space and read where they lie. Both sides
+// spin briefly when the ring is full (empty) and then sleep on a futex; the
+// other side only makes the wake-up syscall when it sees a sleeper, so a busy
+// ring never enters the kernel. Each process uses its object for one role
+// only: begin_write/end_write on the producer, read/release on the consumer.
+class ShmRing {
+public:
+    // Create the named segment with capacity bytes (a power of two, at least
+    // 4 KB); the creator unlinks the name when it is destroyed
+    ShmRing(const std::string& name, size_t capacity);
+
+    // Attach to a segment created by another process
+    explicit ShmRing(const std::string& name);
+
+    ~ShmRing();
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    // Space for a len-byte message of the given type (type 0 is reserved),
+    // blocking while the ring is full. Messages may take up to half the ring.
+    // Throws std::runtime_error if the ring has been closed.
+    uint8_t* begin_write(uint32_t type, size_t len);
+    void end_write();  // publishes the message
+
+    // Next message, blocking while the ring is empty; false once the ring is
+    // closed and drained. The peer is not trusted: a record header that does
+    // not fit in what was published throws std::runtime_error.
+    bool read(RingRecord& record);
+    bool try_read(RingRecord& record);
+    void release();  // frees the space of the message returned by read()
+
+    // Either side may close; blocked peers wake up
+    void close();
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Header;
+
+    void map(int fd, size_t bytes);
+    bool next(RingRecord& record);
+
+    std::string name_;
+    bool owner_;
+    Header* header_;
+    uint8_t* data_;
+    size_t capacity_;
+    size_t mapped_;
+    uint64_t write_end_;  // producer: end of the message being written
+    uint64_t read_pos_;   // consumer: end of the message last returned
+};
+
+// Protocol messages. Vectors mod q travel as fixed-width little-endian words
+// of NumBytes(q) bytes, challenges as one signed byte per coefficient. The
+// ZZ_p modulus must be set on both ends.
+enum class RingMessage : uint32_t { Commitment = 1, Challenge = 2, Response = 3, Verdict = 4 };
+
+void send_commitment(ShmRing& ring, const NTL::vec_ZZ_p& u);
+void send_challenge(ShmRing& ring, const NTL::vec_ZZ& c);
+void send_response(ShmRing& ring, const NTL::vec_ZZ& z);
+void send_verdict(ShmRing& ring, bool accepted);
+
+// Decode the next message, which must be of the expected type and a whole
+// number of coefficients (otherwise std::runtime_error); false if the ring was
+// closed. Responses come back as centered representatives.
+bool receive_commitment(ShmRing& ring, NTL::vec_ZZ_p& u);
+bool receive_challenge(ShmRing& ring, NTL::vec_ZZ& c);
+bool receive_response(ShmRing& ring, NTL::vec_ZZ& z);
+bool receive_verdict(ShmRing& ring, bool& accepted);
+
+} // namespace protocol
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "kernels.hpp"
+#include <NTL/ZZ.h>
+#include <NTL/mat_ZZ_p.h>
+#include <NTL/vec_ZZ_p.h>
+#include <cstdint>
+#include <vector>
+
+namespace protocol {
+
+// Residue number system over primes p = k * 2^20 + 1 < 2^31 (NTT-friendly)
+class RnsBasis {
+public:
+    RnsBasis() = default;
+
+    // Smallest basis whose product P exceeds 2 * bound, so any integer in
+    // [-bound, bound] is recovered exactly by centered CRT
+    explicit RnsBasis(const NTL::ZZ& bound);
+
+    size_t size() const { return primes_.size(); }
+    uint32_t prime(size_t k) const { return primes_[k]; }
+    const NTL::ZZ& product() const { return product_; }
+    size_t heap_bytes() const;
+
+    // Centered CRT reconstruction of residues[0..size()) into (-P/2, P/2]
+    NTL::ZZ reconstruct(const uint32_t* residues) const;
+
+private:
+    std::vector<uint32_t> primes_;
+    std::vector<uint32_t> inverses_;      // (P / p_k)^-1 mod p_k
+    std::vector<NTL::ZZ> cofactors_;      // P / p_k
+    NTL::ZZ product_;
+};
+
+// Matrix mod q kept as one word-sized residue matrix per RNS channel. Products
+// with small vectors are computed exactly over the integers channel by channel
+// (in parallel for large shapes, outside a SerialKernelScope) and reduced mod
+// q only after reconstruction.
+class RnsMatrix {
+public:
+    RnsMatrix() = default;
+
+    // Supports vectors with entries in [-max_coeff, max_coeff], max_coeff < 2^31
+    RnsMatrix(const NTL::mat_ZZ_p& M, long max_coeff);
+
+    long max_coeff() const { return max_coeff_; }
+    size_t channels() const { return channels_.size(); }
+    size_t heap_bytes() const;  // residue matrices and basis tables
+
+    // M * v mod q; the current ZZ_p modulus must be q
+    NTL::vec_ZZ_p multiply(const std::vector<int32_t>& v) const;
+
+private:
+    long rows_ = 0;
+    long cols_ = 0;
+    long max_coeff_ = 0;
+    RnsBasis basis_;
+    std::vector<NativeMatrix> channels_;
+};
+
+} // namespace protocol
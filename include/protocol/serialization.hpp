@@ -0,0 +1,27 @@
+#pragma once
+
+#include "bytes.hpp"
+#include "parameters.hpp"
+#include <NTL/ZZ.h>
+#include <string>
+#include <vector>
+
+namespace protocol {
+
+// Arbitrary-size integers as a u32 byte count followed by little-endian magnitude
+void write_zz(ByteWriter& out, const NTL::ZZ& v);
+NTL::ZZ read_zz(ByteReader& in);
+
+// Parameter block shared by key files and transcript archives
+void write_parameters(ByteWriter& out, const Parameters& params);
+Parameters read_parameters(ByteReader& in);
+
+// Key files: "LZKK", version, parameter block, then the key material written by
+// LatticeProof::save_key. read_key_parameters consumes everything up to the key material.
+void write_key_header(ByteWriter& out, const Parameters& params);
+Parameters read_key_parameters(ByteReader& in);
+
+std::vector<uint8_t> read_file(const std::string& path);
+void write_file(const std::string& path, const std::vector<uint8_t>& bytes);
+
+} // namespace protocol
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace protocol {
+
+// Non-owning view of count contiguous T (std::span is C++20). Converts from
+// any container with data() and size(), including std::pmr::vector.
+template <class T>
+class Span {
+public:
+    Span() = default;
+    Span(T* data, size_t size) : data_(data), size_(size) {}
+
+    template <class Container,
+              class = std::enable_if_t<std::is_convertible_v<
+                  decltype(std::declval<Container&>().data()), T*>>>
+    Span(Container& c) : data_(c.data()), size_(c.size()) {}
+
+    T* data() const { return data_; }
+    size_t size() const { return size_; }
+    T& operator[](size_t i) const { return data_[i]; }
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace protocol
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "lattice_proof.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace protocol {
+
+// Incremental verify() for a response that arrives in pieces. Az is built up
+// column block by column block as coefficients of z are fed, next to the
+// running norm, so most of the matrix product overlaps the transfer and a
+// response that breaks the norm bound is rejected at the first coefficient
+// that pushes it over, without reading the rest.
+//
+// On the native path blocks go through small_matvec_columns; wider moduli
+// accumulate with NTL arithmetic. One verifier handles one transcript at a
+// time; begin() starts the next. The proof must outlive it.
+class StreamingVerifier {
+public:
+    explicit StreamingVerifier(const LatticeProof& proof);
+
+    // Same dimension and challenge checks as verify()
+    void begin(const NTL::vec_ZZ_p& u, const NTL::vec_ZZ& challenge);
+    void begin(const NTL::vec_ZZ_p& u, const SparseChallenge& challenge);
+
+    // Next coefficients of z, in order. Returns false once the transcript is
+    // rejected; later chunks are then ignored. Feeding more than m
+    // coefficients throws std::invalid_argument.
+    bool feed(const NTL::vec_ZZ& chunk);
+
+    // Raw response bytes in the ring wire format (NumBytes(q) little-endian
+    // residues per coefficient); a coefficient may be split across calls
+    bool feed(const uint8_t* data, size_t len);
+
+    // Verdict for the whole transcript; throws std::invalid_argument if z was
+    // cut short (unless already rejected)
+    bool finish();
+
+    bool rejected() const { return rejected_; }
+    long consumed() const { return consumed_; }
+
+private:
+    void start(const NTL::vec_ZZ_p& u, long norm_bound);
+    bool push(const NTL::ZZ& coefficient);
+    void flush();
+
+    const LatticeProof& proof_;
+
+    NTL::vec_ZZ_p u_;
+    NTL::vec_ZZ_p ct_;  // A(c*s)
+    long norm_bound_ = 0;
+    long norm_ = 0;
+    long consumed_ = 0;
+    bool active_ = false;
+    bool rejected_ = false;
+
+    // Centered coefficients not yet multiplied in, starting at column flushed_
+    long flushed_ = 0;
+    std::vector<int32_t> pending_;
+    std::vector<uint32_t> acc_native_;
+    NTL::vec_ZZ_p acc_;
+
+    std::vector<uint8_t> partial_;  // bytes of a split coefficient
+};
+
+} // namespace protocol
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "kernels.hpp"
+#include <NTL/ZZ.h>
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace protocol {
+
+// Native small-coefficient matvec strategies (all give identical results)
+enum class MatvecKernel { Scalar, Blocked, Avx2, Threaded, Fma };
+
+const char* kernel_name(MatvecKernel kernel);
+bool kernel_from_name(const std::string& name, MatvecKernel& kernel);
+
+// Whether kernel can run on this machine for modulus q
+bool kernel_available(MatvecKernel kernel, uint32_t q);
+
+// How to run M * v for one shape: which kernel, how many threads for the
+// threaded kernel, and the largest useful batch of vectors per pass
+struct KernelPlan {
+    MatvecKernel kernel = MatvecKernel::Scalar;
+    unsigned threads = 1;
+    long batch = 8;
+
+    bool operator==(const KernelPlan& other) const {
+        return kernel == other.kernel && threads == other.threads && batch == other.batch;
+    }
+};
+
+// out = M * v for count vectors laid out back to back, through plan. The Fma
+// kernel runs on panels (built on the fly when null) and takes the integer
+// path instead for vectors too large to keep a whole row exact.
+void plan_matvec(const KernelPlan& plan, const NativeMatrix& M, const int32_t* v,
+                 long count, uint32_t* out, const PanelMatrix* panels = nullptr);
+
+// Seconds per vector for each candidate measured by tune_kernels
+struct TuningResult {
+    KernelPlan plan;
+    std::vector<std::pair<std::string, double>> timings;
+};
+
+// Micro-benchmark every available kernel on a random rows x cols matrix mod q
+// (q < 2^32), plus the NTL reference as a baseline, and pick the fastest
+TuningResult tune_kernels(long rows, long cols, const NTL::ZZ& q);
+
+// Host identifier that plans are keyed by: CPU model and hardware threads
+std::string cpu_model();
+
+// Tab-separated plan file, one line per (cpu, rows, cols, bits(q))
+class KernelPlanCache {
+public:
+    // Missing or unreadable files load as empty; malformed lines are skipped.
+    // save() creates parent directories and replaces the file atomically.
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    bool lookup(const std::string& cpu, long rows, long cols, long q_bits, KernelPlan& plan) const;
+    void store(const std::string& cpu, long rows, long cols, long q_bits, const KernelPlan& plan);
+    size_t size() const { return plans_.size(); }
+
+private:
+    std::map<std::tuple<std::string, long, long, long>, KernelPlan> plans_;
+};
+
+// Process-wide plan selection. Off always uses the default plan, Cached uses
+// cached plans when present, and Tune also tunes and caches missing shapes at
+// first use. The library starts Off, so no per-user file changes which kernel
+// runs unless the process opts in: through set_autotune, or by setting
+// LATTICE_ZKP_AUTOTUNE (off, cached, tune). The cache is
+// default_kernel_cache_path() unless another is given.
+enum class AutotuneMode { Off, Cached, Tune };
+
+void set_autotune(AutotuneMode mode, const std::string& cache_path = "");
+
+// Mode named by LATTICE_ZKP_AUTOTUNE, or fallback when it is unset; tools call
+// set_autotune(autotune_mode_from_env(AutotuneMode::Cached)) to opt in
+AutotuneMode autotune_mode_from_env(AutotuneMode fallback);
+
+// LATTICE_ZKP_KERNEL_CACHE if set, else lattice_zkp/kernels.tsv under
+// $XDG_CACHE_HOME or ~/.cache
+std::string default_kernel_cache_path();
+
+// Plan for a native rows x cols matrix mod q (thread-safe)
+KernelPlan kernel_plan(long rows, long cols, const NTL::ZZ& q);
+
+} // namespace protocol
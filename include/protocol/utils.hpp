@@ -1,11 +1,14 @@
 #pragma once
 #include "parameters.hpp"  // Add this include
+#include "kernels.hpp"
 
 #include <NTL/ZZ.h>
 #include <NTL/vec_ZZ.h>
 #include <NTL/mat_ZZ_p.h>
 #include <NTL/vec_ZZ_p.h>
+#include <array>
 #include <string>
+#include <vector>
 
 namespace protocol {
 
@@ -13,14 +16,36 @@ namespace protocol {
 NTL::vec_ZZ sample_ternary(int length);
 NTL::vec_ZZ sample_uniform(int length, long bound);
 
+// Uniform rows x cols matrix mod the current ZZ_p modulus expanded from a
+// public seed: row i is rejection-sampled from SHAKE128(domain, seed, i), and
+// rows are squeezed eight at a time through the multi-buffer permutation
+using MatrixSeed = std::array<uint8_t, 32>;
+NTL::mat_ZZ_p expand_matrix(const MatrixSeed& seed, long rows, long cols);
+
 // Vector operations
 NTL::vec_ZZ_p matrix_vector_mod(const NTL::mat_ZZ_p& M, const NTL::vec_ZZ& v);
 NTL::ZZ compute_norm_squared(const NTL::vec_ZZ& v, const NTL::ZZ& q);
 
+// Native word-sized representations (only valid when fits_native(q))
+bool fits_native(const NTL::ZZ& q);
+NativeMatrix to_native(const NTL::mat_ZZ_p& M);
+std::vector<int32_t> to_centered(const NTL::vec_ZZ& v, const NTL::ZZ& q);
+bool to_ternary(const NTL::vec_ZZ& v, std::vector<int8_t>& out);
+
+// Centered residues of v mod q (any q); false if some |entry| exceeds bound
+bool to_small_centered(const NTL::vec_ZZ& v, const NTL::ZZ& q, long bound,
+                       std::vector<int32_t>& out);
+NTL::vec_ZZ_p from_native(const uint32_t* v, long length);
+
+// Fixed-width little-endian encoding of a vector mod q (NumBytes(q) per entry)
+std::vector<uint8_t> to_bytes(const NTL::vec_ZZ_p& v);
+
 // Norm calculations
 long calculate_norm_bound(int m, int y_range, int s_range, double safety_factor = 10.0);
 double calculate_expected_y_contribution(int m, int y_range);
 double calculate_expected_s_contribution(int m, int s_range);
+long calculate_sparse_norm_bound(int m, int weight, int y_range, int s_range,
+                                 double safety_factor = 10.0);
 
 // Challenge generation
 NTL::vec_ZZ generate_challenge(int length);
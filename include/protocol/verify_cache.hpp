@@ -0,0 +1,68 @@
+#pragma once
+
+#include "lattice_proof.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace protocol {
+
+// SHAKE256 over the verifier's public key digest and the transcript: u as
+// residues mod q, c and z as exact integers. Any change to the key or the
+// transcript changes the digest.
+using TranscriptDigest = std::array<uint8_t, 32>;
+
+TranscriptDigest transcript_digest(const LatticeProof& proof, const Transcript& t);
+TranscriptDigest transcript_digest(const LatticeProof& proof, const NonInteractiveProof& p);
+
+struct VerifyCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t insertions = 0;
+    uint64_t evictions = 0;
+
+    double hit_rate() const {
+        return hits + misses ? static_cast<double>(hits) / (hits + misses) : 0.0;
+    }
+};
+
+// Bounded map from transcript digest to verdict, shared by verifying threads.
+// Entries are spread over independently locked shards, each a fixed slot
+// array with CLOCK eviction: a hit marks its slot, and the insertion hand
+// passes over marked slots once before reusing them.
+//
+// Only verdicts that are a pure function of key and transcript may be cached,
+// which holds for verify(); malformed-input errors are never stored.
+class VerifyCache {
+public:
+    explicit VerifyCache(size_t capacity, size_t shards = 16);
+    ~VerifyCache();
+
+    VerifyCache(const VerifyCache&) = delete;
+    VerifyCache& operator=(const VerifyCache&) = delete;
+
+    bool lookup(const TranscriptDigest& key, bool& accepted);
+    void insert(const TranscriptDigest& key, bool accepted);
+    void clear();  // drops entries, keeps statistics
+
+    size_t size() const;
+    size_t capacity() const { return capacity_; }
+    VerifyCacheStats stats() const;
+
+private:
+    struct Shard;
+
+    Shard& shard(const TranscriptDigest& key);
+
+    size_t capacity_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+// verify() through the cache: a resubmitted transcript costs one digest.
+// std::invalid_argument from malformed input propagates uncached.
+bool verify_cached(const LatticeProof& proof, VerifyCache& cache, const Transcript& t);
+bool verify_cached(const LatticeProof& proof, VerifyCache& cache, const NonInteractiveProof& p);
+
+} // namespace protocol
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "lattice_proof.hpp"
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace protocol {
+
+// Per-thread buffers for the Span overloads of LatticeProof, sized once from
+// the parameters so that commit/respond/verify allocate nothing afterwards.
+// Storage comes from a polymorphic memory resource, so a workspace can live
+// in an arena or on the stack through std::pmr::monotonic_buffer_resource.
+// A workspace holds at most one open commitment; it is not thread-safe, but
+// any number of workspaces may share one LatticeProof.
+class Workspace {
+public:
+    explicit Workspace(const Parameters& params,
+                       std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    long n() const { return n_; }
+    long m() const { return m_; }
+    bool has_commitment() const { return armed_; }
+
+    const RejectionStats& rejection_stats() const { return stats_; }
+    void reset_rejection_stats() { stats_ = RejectionStats(); }
+
+private:
+    friend class LatticeProof;
+
+    long n_;
+    long m_;
+    std::pmr::vector<int32_t> y_;  // mask of the open commitment
+    bool armed_ = false;
+    std::pmr::vector<int8_t> cs_;  // c*s, or the dense form of a sparse c
+    std::pmr::vector<uint64_t> pos_;
+    std::pmr::vector<uint64_t> neg_;
+    std::pmr::vector<uint32_t> ct_;  // A(c*s)
+    std::pmr::vector<uint32_t> w_;   // Az
+    RejectionStats stats_;
+};
+
+} // namespace protocol
@@ -0,0 +1,74 @@
+// Counting malloc interposer for allocation accounting (see memory.hpp).
+// Link the lattice_zkp_alloc_hook object library into an executable to
+// enable it; it forwards to glibc's allocator and reports usable sizes.
+#include "protocol/memory.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <malloc.h>
+
+#if defined(__GLIBC__)
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace {
+
+void* counted(void* p) {
+    if (p) protocol::record_allocation(malloc_usable_size(p));
+    return p;
+}
+
+} // namespace
+
+extern "C" {
+
+void* malloc(size_t size) {
+    return counted(__libc_malloc(size));
+}
+
+void* calloc(size_t count, size_t size) {
+    return counted(__libc_calloc(count, size));
+}
+
+void* realloc(void* ptr, size_t size) {
+    if (ptr) protocol::record_free(malloc_usable_size(ptr));
+    void* p = __libc_realloc(ptr, size);
+    // A failed realloc leaves the old block alive
+    if (!p && ptr && size) {
+        protocol::record_allocation(malloc_usable_size(ptr));
+        return p;
+    }
+    return counted(p);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    return counted(__libc_memalign(alignment, size));
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    return counted(__libc_memalign(alignment, size));
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) {
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void* p = counted(__libc_memalign(alignment, size));
+    if (!p) return ENOMEM;
+    *out = p;
+    return 0;
+}
+
+void free(void* ptr) {
+    if (ptr) protocol::record_free(malloc_usable_size(ptr));
+    __libc_free(ptr);
+}
+
+} // extern "C"
+
+#endif
@@ -0,0 +1,490 @@
+#include "protocol/archive.hpp"
+#include "protocol/batch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace protocol {
+
+namespace {
+
+const uint32_t kArchiveVersion = 1;
+const size_t kTrailerSize = 12;  // u64 index offset + "LZKE"
+const int kTritsPerByte = 5;     // 3^5 = 243 <= 256
+
+// Integers of any width are packed in 63-bit chunks
+void put_zz_bits(BitWriter& bits, NTL::ZZ v, long width) {
+    while (width > 0) {
+        long take = std::min(width, 63L);
+        bits.put(static_cast<uint64_t>(NTL::trunc_long(v, take)), static_cast<int>(take));
+        v >>= take;
+        width -= take;
+    }
+}
+
+NTL::ZZ get_zz_bits(BitReader& bits, long width) {
+    NTL::ZZ v(0);
+    for (long shift = 0; shift < width; shift += 63) {
+        long take = std::min(width - shift, 63L);
+        v += NTL::ZZ(static_cast<long>(bits.get(static_cast<int>(take)))) << shift;
+    }
+    return v;
+}
+
+// Centered representative of z mod q, zigzag-encoded as a non-negative integer
+NTL::ZZ zigzag(const NTL::ZZ& z, const NTL::ZZ& q) {
+    NTL::ZZ c = z % q;
+    if (c > q / 2) c -= q;
+    return c >= 0 ? 2 * c : -2 * c - 1;
+}
+
+NTL::ZZ unzigzag(const NTL::ZZ& v, const NTL::ZZ& q) {
+    NTL::ZZ c = NTL::bit(v, 0) ? -((v + 1) >> 1) : (v >> 1);
+    return c % q;
+}
+
+struct SegmentView {
+    uint32_t records;
+    int z_width;
+    const uint8_t* u;
+    size_t u_bytes;
+    const uint8_t* c;
+    size_t c_bytes;
+    const uint8_t* z;
+    size_t z_bytes;
+};
+
+std::vector<uint8_t> encode_segment(const Parameters& params, const std::vector<Transcript>& records) {
+    const long q_bits = NTL::NumBits(params.q());
+    std::vector<uint8_t> u_col, c_col, z_col;
+
+    BitWriter u_bits(u_col);
+    for (const Transcript& t : records) {
+        for (long i = 0; i < t.u.length(); i++) {
+            put_zz_bits(u_bits, rep(t.u[i]), q_bits);
+        }
+    }
+    u_bits.flush();
+
+    uint32_t trit_acc = 0;
+    uint32_t trit_scale = 1;
+    for (const Transcript& t : records) {
+        for (long j = 0; j < t.challenge.length(); j++) {
+            trit_acc += static_cast<uint32_t>(NTL::conv<long>(t.challenge[j]) + 1) * trit_scale;
+            trit_scale *= 3;
+            if (trit_scale == 243) {
+                c_col.push_back(static_cast<uint8_t>(trit_acc));
+                trit_acc = 0;
+                trit_scale = 1;
+            }
+        }
+    }
+    if (trit_scale > 1) c_col.push_back(static_cast<uint8_t>(trit_acc));
+
+    std::vector<NTL::ZZ> zz;
+    long z_width = 1;
+    for (const Transcript& t : records) {
+        for (long j = 0; j < t.z.length(); j++) {
+            zz.push_back(zigzag(t.z[j], params.q()));
+            z_width = std::max(z_width, NTL::NumBits(zz.back()));
+        }
+    }
+    BitWriter z_bits(z_col);
+    for (const NTL::ZZ& v : zz) {
+        put_zz_bits(z_bits, v, z_width);
+    }
+    z_bits.flush();
+
+    ByteWriter seg;
+    seg.put_tag("LZKS");
+    seg.put_u32(static_cast<uint32_t>(records.size()));
+    seg.put_u32(static_cast<uint32_t>(z_width));
+    seg.put_u64(u_col.size());
+    seg.put_u64(c_col.size());
+    seg.put_u64(z_col.size());
+    seg.put_bytes(u_col.data(), u_col.size());
+    seg.put_bytes(c_col.data(), c_col.size());
+    seg.put_bytes(z_col.data(), z_col.size());
+    return std::move(seg.bytes());
+}
+
+SegmentView parse_segment(ByteReader& in) {
+    in.expect_tag("LZKS");
+    SegmentView view;
+    view.records = in.get_u32();
+    view.z_width = static_cast<int>(in.get_u32());
+    view.u_bytes = in.get_u64();
+    view.c_bytes = in.get_u64();
+    view.z_bytes = in.get_u64();
+    view.u = in.get_bytes(view.u_bytes);
+    view.c = in.get_bytes(view.c_bytes);
+    view.z = in.get_bytes(view.z_bytes);
+    return view;
+}
+
+Transcript decode_record(const Parameters& params, const SegmentView& seg, uint32_t r) {
+    const long n = params.n();
+    const long m = params.m();
+    const long q_bits = NTL::NumBits(params.q());
+    Transcript t;
+
+    BitReader u_bits(seg.u, seg.u_bytes, static_cast<uint64_t>(r) * n * q_bits);
+    t.u.SetLength(n);
+    for (long i = 0; i < n; i++) {
+        t.u[i] = NTL::conv<NTL::ZZ_p>(get_zz_bits(u_bits, q_bits));
+    }
+
+    t.challenge.SetLength(m);
+    for (long j = 0; j < m; j++) {
+        uint64_t trit = static_cast<uint64_t>(r) * m + j;
+        if (trit / kTritsPerByte >= seg.c_bytes) {
+            throw std::runtime_error("Unexpected end of challenge column");
+        }
+        uint32_t byte = seg.c[trit / kTritsPerByte];
+        for (uint64_t k = 0; k < trit % kTritsPerByte; k++) byte /= 3;
+        t.challenge[j] = static_cast<long>(byte % 3) - 1;
+    }
+
+    BitReader z_bits(seg.z, seg.z_bytes, static_cast<uint64_t>(r) * m * seg.z_width);
+    t.z.SetLength(m);
+    for (long j = 0; j < m; j++) {
+        t.z[j] = unzigzag(get_zz_bits(z_bits, seg.z_width), params.q());
+    }
+    return t;
+}
+
+Parameters parse_header(ByteReader& in, uint32_t& segment_records) {
+    in.expect_tag("LZKA");
+    if (in.get_u32() != kArchiveVersion) {
+        throw std::runtime_error("Unsupported archive version");
+    }
+    Parameters params = read_parameters(in);
+    segment_records = in.get_u32();
+    return params;
+}
+
+Parameters read_archive_parameters(const MappedFile& file) {
+    ByteReader in(file.data(), file.size());
+    uint32_t segment_records;
+    return parse_header(in, segment_records);
+}
+
+// Read the index from the trailer, or rebuild it by scanning segments when the
+// archive was not closed. segments_end receives the offset just past the last
+// complete segment.
+std::vector<ArchiveSegment> load_index(const uint8_t* data, size_t size,
+                                       size_t header_end, uint64_t& segments_end) {
+    std::vector<ArchiveSegment> index;
+    if (size >= header_end + kTrailerSize &&
+        std::equal(data + size - 4, data + size, "LZKE")) {
+        ByteReader trailer(data + size - kTrailerSize, kTrailerSize);
+        uint64_t index_offset = trailer.get_u64();
+        if (index_offset < header_end || index_offset > size - kTrailerSize) {
+            throw std::runtime_error("Corrupt archive index offset");
+        }
+        ByteReader in(data + index_offset, size - kTrailerSize - index_offset);
+        in.expect_tag("LZKI");
+        uint64_t count = in.get_u64();
+        for (uint64_t k = 0; k < count; k++) {
+            ArchiveSegment seg;
+            seg.offset = in.get_u64();
+            seg.first_record = in.get_u64();
+            seg.records = in.get_u32();
+            index.push_back(seg);
+        }
+        segments_end = index_offset;
+        return index;
+    }
+
+    ByteReader in(data, size);
+    in.seek(header_end);
+    uint64_t records = 0;
+    segments_end = header_end;
+    while (in.remaining() > 0) {
+        size_t offset = in.position();
+        try {
+            SegmentView view = parse_segment(in);
+            index.push_back({offset, records, view.records});
+            records += view.records;
+            segments_end = in.position();
+        } catch (const std::runtime_error&) {
+            break;  // torn final segment or stale index
+        }
+    }
+    return index;
+}
+
+} // namespace
+
+MappedFile::MappedFile(const std::string& path)
+    : data_(nullptr), size_(0) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map " + path);
+        }
+        ::madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const uint8_t*>(p);
+    }
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data_) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+}
+
+ArchiveWriter::ArchiveWriter(const std::string& path, const Parameters& params,
+                             uint32_t segment_records)
+    : params_(params), segment_records_(segment_records), path_(path),
+      offset_(0), records_(0), closed_(false) {
+    if (segment_records_ == 0) {
+        throw std::invalid_argument("Segment size must be positive");
+    }
+
+    std::error_code ec;
+    if (std::filesystem::exists(path_) && std::filesystem::file_size(path_, ec) > 0) {
+        uint64_t segments_end = 0;
+        {
+            MappedFile file(path_);
+            ByteReader in(file.data(), file.size());
+            Parameters existing = parse_header(in, segment_records_);
+            if (existing != params_) {
+                throw std::invalid_argument("Archive parameters do not match");
+            }
+            index_ = load_index(file.data(), file.size(), in.position(), segments_end);
+        }
+        for (const ArchiveSegment& seg : index_) {
+            records_ += seg.records;
+        }
+        // Drop the old index (or a torn segment); a new index is written on close
+        std::filesystem::resize_file(path_, segments_end);
+        offset_ = segments_end;
+        out_.open(path_, std::ios::binary | std::ios::app);
+    } else {
+        out_.open(path_, std::ios::binary | std::ios::trunc);
+        ByteWriter header;
+        header.put_tag("LZKA");
+        header.put_u32(kArchiveVersion);
+        write_parameters(header, params_);
+        header.put_u32(segment_records_);
+        out_.write(reinterpret_cast<const char*>(header.bytes().data()), header.bytes().size());
+        offset_ = header.bytes().size();
+    }
+    if (!out_) {
+        throw std::runtime_error("Cannot open " + path_ + " for writing");
+    }
+}
+
+ArchiveWriter::~ArchiveWriter() {
+    try {
+        close();
+    } catch (...) {
+        // Segments already written stay recoverable by scanning
+    }
+}
+
+void ArchiveWriter::append(const Transcript& t) {
+    if (closed_) {
+        throw std::logic_error("Archive is closed");
+    }
+    if (t.u.length() != params_.n()) {
+        throw std::invalid_argument("Commitment vector has wrong dimension");
+    }
+    if (t.challenge.length() != params_.m()) {
+        throw std::invalid_argument("Challenge vector has wrong dimension");
+    }
+    if (t.z.length() != params_.m()) {
+        throw std::invalid_argument("Response vector has wrong dimension");
+    }
+    for (long j = 0; j < t.challenge.length(); j++) {
+        if (t.challenge[j] < -1 || t.challenge[j] > 1) {
+            throw std::invalid_argument("Archive only stores ternary challenges");
+        }
+    }
+    pending_.push_back(t);
+    if (pending_.size() == segment_records_) {
+        write_segment();
+    }
+}
+
+void ArchiveWriter::flush() {
+    if (!pending_.empty()) {
+        write_segment();
+    }
+    out_.flush();
+}
+
+void ArchiveWriter::close() {
+    if (closed_) return;
+    flush();
+
+    ByteWriter trailer;
+    trailer.put_tag("LZKI");
+    trailer.put_u64(index_.size());
+    for (const ArchiveSegment& seg : index_) {
+        trailer.put_u64(seg.offset);
+        trailer.put_u64(seg.first_record);
+        trailer.put_u32(seg.records);
+    }
+    trailer.put_u64(offset_);
+    trailer.put_tag("LZKE");
+    out_.write(reinterpret_cast<const char*>(trailer.bytes().data()), trailer.bytes().size());
+    out_.close();
+    closed_ = true;
+    if (!out_) {
+        throw std::runtime_error("Failed to write archive index to " + path_);
+    }
+}
+
+void ArchiveWriter::write_segment() {
+    std::vector<uint8_t> bytes = encode_segment(params_, pending_);
+    out_.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    if (!out_) {
+        throw std::runtime_error("Failed to write archive segment to " + path_);
+    }
+    index_.push_back({offset_, records_, static_cast<uint32_t>(pending_.size())});
+    offset_ += bytes.size();
+    records_ += pending_.size();
+    pending_.clear();
+}
+
+ArchiveReader::ArchiveReader(const std::string& path)
+    : file_(path),
+      params_(read_archive_parameters(file_)),
+      records_(0) {
+    ByteReader in(file_.data(), file_.size());
+    uint32_t segment_records;
+    parse_header(in, segment_records);
+    uint64_t segments_end;
+    index_ = load_index(file_.data(), file_.size(), in.position(), segments_end);
+    for (const ArchiveSegment& seg : index_) {
+        records_ += seg.records;
+    }
+}
+
+std::vector<Transcript> ArchiveReader::read_segment(size_t k) const {
+    const ArchiveSegment& entry = index_.at(k);
+    ByteReader in(file_.data(), file_.size());
+    in.seek(entry.offset);
+    SegmentView view = parse_segment(in);
+    if (view.records != entry.records) {
+        throw std::runtime_error("Archive segment does not match its index");
+    }
+    std::vector<Transcript> records;
+    records.reserve(view.records);
+    for (uint32_t r = 0; r < view.records; r++) {
+        records.push_back(decode_record(params_, view, r));
+    }
+    return records;
+}
+
+Transcript ArchiveReader::read(uint64_t record) const {
+    if (record >= records_) {
+        throw std::out_of_range("Archive record out of range");
+    }
+    auto it = std::upper_bound(index_.begin(), index_.end(), record,
+                               [](uint64_t r, const ArchiveSegment& seg) { return r < seg.first_record; });
+    const ArchiveSegment& entry = *(it - 1);
+    ByteReader in(file_.data(), file_.size());
+    in.seek(entry.offset);
+    SegmentView view = parse_segment(in);
+    return decode_record(params_, view, static_cast<uint32_t>(record - entry.first_record));
+}
+
+ReplayReport replay_archive(const ArchiveReader& archive, const LatticeProof& proof,
+                            unsigned threads) {
+    if (archive.parameters() != proof.parameters()) {
+        throw std::invalid_argument("Archive parameters do not match the proof key");
+    }
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ReplayReport report;
+    std::mutex report_mutex;
+    std::exception_ptr failure;
+    std::atomic<size_t> next_segment(0);
+    const NTL::ZZ q = proof.parameters().q();
+
+    auto worker = [&]() {
+        SerialKernelScope serial;
+        uint64_t accepted = 0;
+        std::vector<uint64_t> rejected;
+        std::vector<ArchiveSegment> corrupt;
+        try {
+            // NTL keeps the ZZ_p modulus per thread
+            NTL::ZZ_pContext context(q);
+            context.restore();
+
+            for (size_t k = next_segment++; k < archive.segments().size(); k = next_segment++) {
+                const ArchiveSegment& segment = archive.segments()[k];
+                std::vector<Transcript> records;
+                try {
+                    records = archive.read_segment(k);
+                } catch (const std::runtime_error&) {
+                    // A damaged segment is part of the audit result, not a
+                    // reason to stop replaying the others
+                    corrupt.push_back(segment);
+                    continue;
+                }
+                for (size_t r = 0; r < records.size(); r++) {
+                    if (verify_transcript(proof, records[r])) {
+                        accepted++;
+                    } else {
+                        rejected.push_back(segment.first_record + r);
+                    }
+                }
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(report_mutex);
+            if (!failure) failure = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(report_mutex);
+        report.accepted += accepted;
+        report.rejected.insert(report.rejected.end(), rejected.begin(), rejected.end());
+        report.corrupt.insert(report.corrupt.end(), corrupt.begin(), corrupt.end());
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+    for (std::thread& t : pool) {
+        t.join();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+
+    std::sort(report.rejected.begin(), report.rejected.end());
+    std::sort(report.corrupt.begin(), report.corrupt.end(),
+              [](const ArchiveSegment& a, const ArchiveSegment& b) { return a.first_record < b.first_record; });
+    report.records = archive.size();
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+} // namespace protocol
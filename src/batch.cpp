@@ -0,0 +1,147 @@
+#include "protocol/batch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace protocol {
+
+namespace {
+
+// Chunk indices [begin, end) owned by one worker; the owner takes from the
+// front and thieves from the back
+struct ChunkQueue {
+    std::mutex mutex;
+    size_t begin = 0;
+    size_t end = 0;
+
+    bool pop_front(size_t& chunk) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (begin == end) return false;
+        chunk = begin++;
+        return true;
+    }
+    bool steal_back(size_t& chunk) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (begin == end) return false;
+        chunk = --end;
+        return true;
+    }
+};
+
+template <class Verify>
+BatchVerifyResult run_batch(const LatticeProof& proof, size_t count, unsigned threads,
+                            const Verify& verify_one) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // Several chunks per thread leave room to rebalance, but each stays large
+    // enough that queue traffic is negligible next to verification
+    const size_t chunk_size = std::max<size_t>(1, std::min<size_t>(64, count / (8 * threads)));
+    const size_t chunks = (count + chunk_size - 1) / chunk_size;
+    threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, chunks)));
+
+    std::vector<ChunkQueue> queues(threads);
+    for (unsigned t = 0; t < threads; t++) {
+        queues[t].begin = chunks * t / threads;
+        queues[t].end = chunks * (t + 1) / threads;
+    }
+
+    std::vector<std::atomic<uint64_t>> words((count + 63) / 64);
+    for (auto& w : words) {
+        w.store(0, std::memory_order_relaxed);
+    }
+    std::exception_ptr failure;
+    std::mutex failure_mutex;
+    const NTL::ZZ& q = proof.parameters().q();
+
+    auto worker = [&](unsigned self) {
+        SerialKernelScope serial;
+        try {
+            // NTL keeps the ZZ_p modulus per thread; the push restores the
+            // calling thread's own context on the way out
+            NTL::ZZ_pPush push(q);
+            size_t chunk;
+            for (;;) {
+                bool found = queues[self].pop_front(chunk);
+                for (unsigned k = 1; !found && k < threads; k++) {
+                    found = queues[(self + k) % threads].steal_back(chunk);
+                }
+                if (!found) {
+                    return;
+                }
+                const size_t end = std::min(count, (chunk + 1) * chunk_size);
+                for (size_t i = chunk * chunk_size; i < end; i++) {
+                    if (verify_one(i)) {
+                        words[i / 64].fetch_or(uint64_t(1) << (i % 64), std::memory_order_relaxed);
+                    }
+                }
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(failure_mutex);
+            if (!failure) failure = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (std::thread& t : pool) {
+        t.join();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+
+    BatchVerifyResult result;
+    result.size = count;
+    result.bits.resize(words.size());
+    for (size_t w = 0; w < words.size(); w++) {
+        result.bits[w] = words[w].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+} // namespace
+
+size_t BatchVerifyResult::count() const {
+    size_t n = 0;
+    for (uint64_t w : bits) {
+        n += __builtin_popcountll(w);
+    }
+    return n;
+}
+
+bool verify_transcript(const LatticeProof& proof, const Transcript& t) {
+    try {
+        return proof.verify(t.u, t.challenge, t.z);
+    } catch (const std::invalid_argument&) {
+        return false;
+    }
+}
+
+BatchVerifyResult verify_many(const LatticeProof& proof, const std::vector<Transcript>& transcripts,
+                              unsigned threads) {
+    return run_batch(proof, transcripts.size(), threads,
+                     [&](size_t i) { return verify_transcript(proof, transcripts[i]); });
+}
+
+BatchVerifyResult verify_many(const LatticeProof& proof, const std::vector<NonInteractiveProof>& proofs,
+                              unsigned threads) {
+    // Checked here so a configuration error is not reported as every proof failing
+    if (proof.parameters().commitment_drop_bits() <= 0) {
+        throw std::invalid_argument("Commitment compression is not enabled for these parameters");
+    }
+    return run_batch(proof, proofs.size(), threads, [&](size_t i) {
+        try {
+            return proof.verify(proofs[i]);
+        } catch (const std::invalid_argument&) {
+            return false;
+        }
+    });
+}
+
+} // namespace protocol
@@ -0,0 +1,217 @@
+#include "protocol/challenge.hpp"
+#include "protocol/hash.hpp"
+#include "protocol/utils.hpp"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+namespace protocol {
+
+namespace {
+
+const char kChallengeDomain[] = "lattice_zkp/sparse_challenge";
+
+long index_bits(int length) {
+    return length > 1 ? NTL::NumBits(static_cast<long>(length - 1)) : 1;
+}
+
+// Sort the support ascending so sparse products walk each row forward
+void sort_support(SparseChallenge& c) {
+    std::vector<int> order(c.weight());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&](int a, int b) { return c.index[a] < c.index[b]; });
+    SparseChallenge sorted;
+    sorted.length = c.length;
+    for (int k : order) {
+        sorted.index.push_back(c.index[k]);
+        sorted.sign.push_back(c.sign[k]);
+    }
+    c = std::move(sorted);
+}
+
+// Distinct positions by rejection: draw(bound) must return a value in [0, bound)
+template <typename Draw>
+SparseChallenge sample_support(int length, int weight, Draw draw) {
+    if (weight < 0 || weight > length) {
+        throw std::invalid_argument("Challenge weight must be in [0, length]");
+    }
+    SparseChallenge c;
+    c.length = length;
+    while (c.weight() < weight) {
+        int32_t j = static_cast<int32_t>(draw(length));
+        if (std::find(c.index.begin(), c.index.end(), j) != c.index.end()) continue;
+        c.index.push_back(j);
+        c.sign.push_back(draw(2) ? 1 : -1);
+    }
+    sort_support(c);
+    return c;
+}
+
+// Uniform draws by masking little-endian 32-bit words from next(buf) to the
+// next power of two and rejecting
+template <typename Next>
+long draw_below(long bound, Next next) {
+    uint32_t mask = bound > 1 ? (uint32_t(1) << NTL::NumBits(bound - 1)) - 1 : 0;
+    for (;;) {
+        uint8_t buf[4];
+        next(buf);
+        uint32_t x = (uint32_t(buf[0]) | uint32_t(buf[1]) << 8 |
+                      uint32_t(buf[2]) << 16 | uint32_t(buf[3]) << 24) & mask;
+        if (x < static_cast<uint32_t>(bound)) return static_cast<long>(x);
+    }
+}
+
+} // namespace
+
+NTL::vec_ZZ SparseChallenge::to_dense() const {
+    NTL::vec_ZZ c;
+    c.SetLength(length);
+    for (int k = 0; k < weight(); k++) {
+        c[index[k]] = sign[k];
+    }
+    return c;
+}
+
+SparseChallenge sample_sparse_challenge(int length, int weight) {
+    return sample_support(length, weight, [](long bound) { return NTL::RandomBnd(bound); });
+}
+
+SparseChallenge derive_sparse_challenge(const uint8_t* seed, size_t seed_len,
+                                        int length, int weight) {
+    return derive_sparse_challenge(nullptr, seed, seed_len, length, weight);
+}
+
+SparseChallenge derive_sparse_challenge(const ChallengeKey* key, const uint8_t* seed,
+                                        size_t seed_len, int length, int weight) {
+    Shake xof(256);
+    xof.absorb(reinterpret_cast<const uint8_t*>(kChallengeDomain), sizeof(kChallengeDomain) - 1);
+    if (key) {
+        xof.absorb(key->data(), key->size());
+    }
+    xof.absorb(seed, seed_len);
+
+    return sample_support(length, weight, [&xof](long bound) {
+        return draw_below(bound, [&xof](uint8_t* buf) { xof.squeeze(buf, 4); });
+    });
+}
+
+std::vector<SparseChallenge> derive_sparse_challenges(const ChallengeKey* key, const uint8_t* const* seeds,
+                                                      size_t seed_len, size_t count, int length, int weight) {
+    std::vector<SparseChallenge> out;
+    if (count == 0) {
+        return out;
+    }
+    ShakeMany xof(256, count);
+    xof.absorb_shared(reinterpret_cast<const uint8_t*>(kChallengeDomain), sizeof(kChallengeDomain) - 1);
+    if (key) {
+        xof.absorb_shared(key->data(), key->size());
+    }
+    xof.absorb(seeds, seed_len);
+
+    // Instances need different amounts of output, so every instance squeezes a
+    // block whenever any runs dry and the rest keep theirs for later
+    std::vector<std::vector<uint8_t>> streams(count);
+    std::vector<uint8_t*> blocks(count);
+    auto refill = [&] {
+        const size_t old = streams[0].size();
+        for (size_t k = 0; k < count; k++) {
+            streams[k].resize(old + xof.rate());
+            blocks[k] = streams[k].data() + old;
+        }
+        xof.squeeze(blocks.data(), xof.rate());
+    };
+
+    out.reserve(count);
+    for (size_t k = 0; k < count; k++) {
+        size_t pos = 0;
+        out.push_back(sample_support(length, weight, [&](long bound) {
+            return draw_below(bound, [&](uint8_t* buf) {
+                while (pos + 4 > streams[k].size()) {
+                    refill();
+                }
+                std::memcpy(buf, streams[k].data() + pos, 4);
+                pos += 4;
+            });
+        }));
+    }
+    return out;
+}
+
+std::vector<SparseChallenge> derive_sparse_challenges(const uint8_t* const* seeds, size_t seed_len,
+                                                      size_t count, int length, int weight) {
+    return derive_sparse_challenges(nullptr, seeds, seed_len, count, length, weight);
+}
+
+SparseChallenge derive_sparse_challenge(const ChallengeKey& key, const NTL::vec_ZZ_p& u,
+                                        int length, int weight) {
+    std::vector<uint8_t> bytes = to_bytes(u);
+    return derive_sparse_challenge(&key, bytes.data(), bytes.size(), length, weight);
+}
+
+long encoded_challenge_bits(int length, int weight) {
+    return static_cast<long>(weight) * (index_bits(length) + 1);
+}
+
+std::vector<uint8_t> encode_challenge(const SparseChallenge& c) {
+    const long bits = index_bits(c.length);
+    std::vector<uint8_t> out((encoded_challenge_bits(c.length, c.weight()) + 7) / 8, 0);
+    long pos = 0;
+    auto put = [&](uint32_t value, long width) {
+        for (long b = 0; b < width; b++, pos++) {
+            if ((value >> b) & 1) out[pos / 8] |= uint8_t(1) << (pos % 8);
+        }
+    };
+    for (int k = 0; k < c.weight(); k++) {
+        put(static_cast<uint32_t>(c.index[k]), bits);
+        put(c.sign[k] < 0 ? 1 : 0, 1);
+    }
+    return out;
+}
+
+SparseChallenge decode_challenge(const std::vector<uint8_t>& bytes, int length, int weight) {
+    if (static_cast<long>(bytes.size()) != (encoded_challenge_bits(length, weight) + 7) / 8) {
+        throw std::invalid_argument("Encoded challenge has wrong size");
+    }
+    const long bits = index_bits(length);
+    long pos = 0;
+    auto get = [&](long width) {
+        uint32_t value = 0;
+        for (long b = 0; b < width; b++, pos++) {
+            value |= uint32_t((bytes[pos / 8] >> (pos % 8)) & 1) << b;
+        }
+        return value;
+    };
+    SparseChallenge c;
+    c.length = length;
+    for (int k = 0; k < weight; k++) {
+        c.index.push_back(static_cast<int32_t>(get(bits)));
+        c.sign.push_back(get(1) ? -1 : 1);
+    }
+    validate_challenge(c, length, weight);
+    return c;
+}
+
+void validate_challenge(const SparseChallenge& c, int length, int weight) {
+    if (weight <= 0) {
+        throw std::invalid_argument("Sparse challenges are not enabled for these parameters");
+    }
+    if (c.length != length) {
+        throw std::invalid_argument("Challenge vector has wrong dimension");
+    }
+    if (c.weight() != weight || c.sign.size() != c.index.size()) {
+        throw std::invalid_argument("Challenge has wrong weight");
+    }
+    for (int k = 0; k < c.weight(); k++) {
+        if (c.index[k] < 0 || c.index[k] >= length ||
+            (k > 0 && c.index[k] <= c.index[k - 1])) {
+            throw std::invalid_argument("Challenge indices must be sorted, distinct and in range");
+        }
+        if (c.sign[k] != 1 && c.sign[k] != -1) {
+            throw std::invalid_argument("Challenge signs must be in {-1,1}");
+        }
+    }
+}
+
+} // namespace protocol
@@ -0,0 +1,136 @@
+#include "protocol/compression.hpp"
+#include "protocol/bytes.hpp"
+#include "protocol/hash.hpp"
+#include <stdexcept>
+
+namespace protocol {
+
+namespace {
+
+const char kCommitmentDomain[] = "lattice_zkp/commitment";
+
+// Low 64 bits of a nonnegative integer
+uint64_t low_word(const NTL::ZZ& x) {
+    unsigned char bytes[8];
+    NTL::BytesFromZZ(bytes, x, sizeof(bytes));
+    uint64_t value = 0;
+    for (int b = 7; b >= 0; b--) {
+        value = (value << 8) | bytes[b];
+    }
+    return value;
+}
+
+// Bits per packed high value, and the largest value (q - 1) >> d
+int high_width(const NTL::ZZ& q, int drop_bits, uint64_t& max_high) {
+    const long width = NTL::NumBits(q) - drop_bits;
+    if (drop_bits < 0 || width < 1 || width > 64) {
+        throw std::invalid_argument("Commitment drop bits must leave between 1 and 64 high bits");
+    }
+    max_high = low_word((q - 1) >> drop_bits);
+    return static_cast<int>(width);
+}
+
+} // namespace
+
+CompressedCommitment compress_commitment(const NTL::vec_ZZ_p& u, int drop_bits) {
+    CompressedCommitment w1;
+    w1.high.resize(u.length());
+    for (long i = 0; i < u.length(); i++) {
+        w1.high[i] = low_word(rep(u[i]) >> drop_bits);
+    }
+    return w1;
+}
+
+CommitmentDigest commitment_digest(const CompressedCommitment& w1) {
+    Shake xof(256);
+    xof.absorb(reinterpret_cast<const uint8_t*>(kCommitmentDomain), sizeof(kCommitmentDomain) - 1);
+    for (uint64_t value : w1.high) {
+        uint8_t bytes[8];
+        for (int b = 0; b < 8; b++) {
+            bytes[b] = static_cast<uint8_t>(value >> (8 * b));
+        }
+        xof.absorb(bytes, sizeof(bytes));
+    }
+    CommitmentDigest digest;
+    xof.squeeze(digest.data(), digest.size());
+    return digest;
+}
+
+std::vector<CommitmentDigest> commitment_digests(const std::vector<CompressedCommitment>& w1s) {
+    std::vector<CommitmentDigest> digests(w1s.size());
+    const size_t length = w1s.empty() ? 0 : w1s[0].high.size();
+    bool same_length = true;
+    for (const auto& w1 : w1s) {
+        same_length = same_length && w1.high.size() == length;
+    }
+    if (!same_length) {
+        for (size_t k = 0; k < w1s.size(); k++) {
+            digests[k] = commitment_digest(w1s[k]);
+        }
+        return digests;
+    }
+
+    // Same byte stream as commitment_digest, serialized up front per instance
+    std::vector<std::vector<uint8_t>> inputs(w1s.size(), std::vector<uint8_t>(8 * length));
+    std::vector<const uint8_t*> in(w1s.size());
+    std::vector<uint8_t*> out(w1s.size());
+    for (size_t k = 0; k < w1s.size(); k++) {
+        for (size_t i = 0; i < length; i++) {
+            for (int b = 0; b < 8; b++) {
+                inputs[k][8 * i + b] = static_cast<uint8_t>(w1s[k].high[i] >> (8 * b));
+            }
+        }
+        in[k] = inputs[k].data();
+        out[k] = digests[k].data();
+    }
+    ShakeMany xof(256, w1s.size());
+    xof.absorb_shared(reinterpret_cast<const uint8_t*>(kCommitmentDomain), sizeof(kCommitmentDomain) - 1);
+    xof.absorb(in.data(), 8 * length);
+    xof.squeeze(out.data(), std::tuple_size<CommitmentDigest>::value);
+    return digests;
+}
+
+long compressed_commitment_bits(int n, const NTL::ZZ& q, int drop_bits) {
+    return static_cast<long>(n) * (NTL::NumBits(q) - drop_bits);
+}
+
+std::vector<uint8_t> encode_commitment(const CompressedCommitment& w1, const NTL::ZZ& q, int drop_bits) {
+    uint64_t max_high;
+    const int width = high_width(q, drop_bits, max_high);
+    std::vector<uint8_t> out;
+    out.reserve((w1.high.size() * width + 7) / 8);
+    BitWriter bits(out);
+    for (uint64_t value : w1.high) {
+        if (value > max_high) {
+            throw std::invalid_argument("Commitment high bits out of range");
+        }
+        bits.put(value, width);
+    }
+    bits.flush();
+    return out;
+}
+
+CompressedCommitment decode_commitment(const std::vector<uint8_t>& bytes, int n,
+                                       const NTL::ZZ& q, int drop_bits) {
+    uint64_t max_high;
+    const int width = high_width(q, drop_bits, max_high);
+    if (n < 0 || static_cast<long>(bytes.size()) != (compressed_commitment_bits(n, q, drop_bits) + 7) / 8) {
+        throw std::invalid_argument("Encoded commitment has wrong size");
+    }
+    CompressedCommitment w1;
+    w1.high.resize(n);
+    BitReader bits(bytes.data(), bytes.size());
+    for (int i = 0; i < n; i++) {
+        w1.high[i] = bits.get(width);
+        if (w1.high[i] > max_high) {
+            throw std::invalid_argument("Commitment high bits out of range");
+        }
+    }
+    // One encoding per commitment: the padding must be zero
+    if (bits.position() % 8 != 0 && (bytes.back() >> (bits.position() % 8)) != 0) {
+        throw std::invalid_argument("Encoded commitment has nonzero padding");
+    }
+    return w1;
+}
+
+} // namespace protocol
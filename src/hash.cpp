@@ -0,0 +1,429 @@
+#include "protocol/hash.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LATTICE_ZKP_X86 1
+#endif
+
+namespace protocol {
+
+namespace {
+
+const uint64_t kRoundConstants[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+// Rotation offsets and lane permutation for the combined rho/pi step
+const int kRho[24] = {
+    1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14,
+    27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44
+};
+const int kPi[24] = {
+    10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4,
+    15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1
+};
+
+inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// Lanes are stored little-endian, so byte i of the state is byte i % 8 of lane i / 8
+inline void xor_byte(uint64_t* state, size_t i, uint8_t b) {
+    state[i / 8] ^= static_cast<uint64_t>(b) << (8 * (i % 8));
+}
+
+inline uint8_t get_byte(const uint64_t* state, size_t i) {
+    return static_cast<uint8_t>(state[i / 8] >> (8 * (i % 8)));
+}
+
+inline uint64_t load_le64(const uint8_t* p) {
+    uint64_t x = 0;
+    for (int b = 0; b < 8; b++) {
+        x |= static_cast<uint64_t>(p[b]) << (8 * b);
+    }
+    return x;
+}
+
+// States per ShakeMany group; one x8 permutation advances a whole group
+const size_t kGroup = 8;
+
+// Scalar fallback: the first count states of a lane-interleaved block
+void keccak_strided(uint64_t* lanes, size_t stride, size_t count) {
+    uint64_t st[25];
+    for (size_t k = 0; k < count; k++) {
+        for (int i = 0; i < 25; i++) {
+            st[i] = lanes[i * stride + k];
+        }
+        keccak_f1600(st);
+        for (int i = 0; i < 25; i++) {
+            lanes[i * stride + k] = st[i];
+        }
+    }
+}
+
+#ifdef LATTICE_ZKP_X86
+bool avx2_keccak() {
+    return __builtin_cpu_supports("avx2");
+}
+
+bool avx512_keccak() {
+    return __builtin_cpu_supports("avx512f");
+}
+
+__attribute__((target("avx2")))
+inline __m256i rotl256(__m256i x, int k) {
+    return _mm256_or_si256(_mm256_sll_epi64(x, _mm_cvtsi32_si128(k)),
+                           _mm256_srl_epi64(x, _mm_cvtsi32_si128(64 - k)));
+}
+
+// The scalar round structure with one state per 64-bit lane of a register;
+// states are read at lanes[i * stride .. i * stride + 3]
+__attribute__((target("avx2")))
+void keccak_x4_avx2(uint64_t* lanes, size_t stride) {
+    __m256i st[25], bc[5];
+    for (int i = 0; i < 25; i++) {
+        st[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes + i * stride));
+    }
+    for (int round = 0; round < 24; round++) {
+        for (int i = 0; i < 5; i++) {
+            bc[i] = _mm256_xor_si256(_mm256_xor_si256(st[i], st[i + 5]),
+                                     _mm256_xor_si256(_mm256_xor_si256(st[i + 10], st[i + 15]), st[i + 20]));
+        }
+        for (int i = 0; i < 5; i++) {
+            __m256i t = _mm256_xor_si256(bc[(i + 4) % 5], rotl256(bc[(i + 1) % 5], 1));
+            for (int j = 0; j < 25; j += 5) {
+                st[j + i] = _mm256_xor_si256(st[j + i], t);
+            }
+        }
+
+        __m256i t = st[1];
+        for (int i = 0; i < 24; i++) {
+            int j = kPi[i];
+            __m256i tmp = st[j];
+            st[j] = rotl256(t, kRho[i]);
+            t = tmp;
+        }
+
+        for (int j = 0; j < 25; j += 5) {
+            for (int i = 0; i < 5; i++) {
+                bc[i] = st[j + i];
+            }
+            for (int i = 0; i < 5; i++) {
+                st[j + i] = _mm256_xor_si256(st[j + i], _mm256_andnot_si256(bc[(i + 1) % 5], bc[(i + 2) % 5]));
+            }
+        }
+
+        st[0] = _mm256_xor_si256(st[0], _mm256_set1_epi64x(static_cast<long long>(kRoundConstants[round])));
+    }
+    for (int i = 0; i < 25; i++) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes + i * stride), st[i]);
+    }
+}
+
+// Same on eight states, with native 64-bit rotates and a three-way XOR.
+// Rotates go through the all-lanes maskz forms: the unmasked intrinsics pass
+// _mm512_undefined_epi32() as the merge source, which GCC 12 reports as used
+// uninitialized under -Wall; with a full mask the instruction is the same.
+__attribute__((target("avx512f")))
+void keccak_x8_avx512(uint64_t* lanes) {
+    const __mmask8 all = 0xFF;
+    __m512i st[25], bc[5];
+    for (int i = 0; i < 25; i++) {
+        st[i] = _mm512_loadu_si512(lanes + i * 8);
+    }
+    for (int round = 0; round < 24; round++) {
+        for (int i = 0; i < 5; i++) {
+            bc[i] = _mm512_ternarylogic_epi64(
+                _mm512_ternarylogic_epi64(st[i], st[i + 5], st[i + 10], 0x96), st[i + 15], st[i + 20], 0x96);
+        }
+        for (int i = 0; i < 5; i++) {
+            __m512i t = _mm512_xor_si512(bc[(i + 4) % 5], _mm512_maskz_rol_epi64(all, bc[(i + 1) % 5], 1));
+            for (int j = 0; j < 25; j += 5) {
+                st[j + i] = _mm512_xor_si512(st[j + i], t);
+            }
+        }
+
+        __m512i t = st[1];
+        for (int i = 0; i < 24; i++) {
+            int j = kPi[i];
+            __m512i tmp = st[j];
+            st[j] = _mm512_maskz_rolv_epi64(all, t, _mm512_set1_epi64(kRho[i]));
+            t = tmp;
+        }
+
+        for (int j = 0; j < 25; j += 5) {
+            for (int i = 0; i < 5; i++) {
+                bc[i] = st[j + i];
+            }
+            // a ^ (~b & c)
+            for (int i = 0; i < 5; i++) {
+                st[j + i] = _mm512_ternarylogic_epi64(st[j + i], bc[(i + 1) % 5], bc[(i + 2) % 5], 0xd2);
+            }
+        }
+
+        st[0] = _mm512_xor_si512(st[0], _mm512_set1_epi64(static_cast<long long>(kRoundConstants[round])));
+    }
+    for (int i = 0; i < 25; i++) {
+        _mm512_storeu_si512(lanes + i * 8, st[i]);
+    }
+}
+#endif
+
+// Permute the first count (<= 8) states of an x8 block
+void keccak_group(uint64_t* lanes, size_t count) {
+#ifdef LATTICE_ZKP_X86
+    if (count > 4 && avx512_keccak()) {
+        keccak_x8_avx512(lanes);
+        return;
+    }
+    if (count > 1 && avx2_keccak()) {
+        keccak_x4_avx2(lanes, 8);
+        if (count > 4) {
+            keccak_x4_avx2(lanes + 4, 8);
+        }
+        return;
+    }
+#endif
+    keccak_strided(lanes, 8, count);
+}
+
+} // namespace
+
+void keccak_f1600(uint64_t st[25]) {
+    uint64_t bc[5];
+    for (int round = 0; round < 24; round++) {
+        // Theta
+        for (int i = 0; i < 5; i++) {
+            bc[i] = st[i] ^ st[i + 5] ^ st[i + 10] ^ st[i + 15] ^ st[i + 20];
+        }
+        for (int i = 0; i < 5; i++) {
+            uint64_t t = bc[(i + 4) % 5] ^ rotl(bc[(i + 1) % 5], 1);
+            for (int j = 0; j < 25; j += 5) {
+                st[j + i] ^= t;
+            }
+        }
+
+        // Rho and pi
+        uint64_t t = st[1];
+        for (int i = 0; i < 24; i++) {
+            int j = kPi[i];
+            uint64_t tmp = st[j];
+            st[j] = rotl(t, kRho[i]);
+            t = tmp;
+        }
+
+        // Chi
+        for (int j = 0; j < 25; j += 5) {
+            for (int i = 0; i < 5; i++) {
+                bc[i] = st[j + i];
+            }
+            for (int i = 0; i < 5; i++) {
+                st[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+            }
+        }
+
+        // Iota
+        st[0] ^= kRoundConstants[round];
+    }
+}
+
+void keccak_f1600_x4(uint64_t lanes[25 * 4]) {
+#ifdef LATTICE_ZKP_X86
+    if (avx2_keccak()) {
+        keccak_x4_avx2(lanes, 4);
+        return;
+    }
+#endif
+    keccak_strided(lanes, 4, 4);
+}
+
+void keccak_f1600_x8(uint64_t lanes[25 * 8]) {
+    keccak_group(lanes, 8);
+}
+
+int keccak_parallelism() {
+#ifdef LATTICE_ZKP_X86
+    if (avx512_keccak()) return 8;
+    if (avx2_keccak()) return 4;
+#endif
+    return 1;
+}
+
+Shake::Shake(int security_bits)
+    : pos_(0), squeezing_(false) {
+    if (security_bits != 128 && security_bits != 256) {
+        throw std::invalid_argument("SHAKE security level must be 128 or 256");
+    }
+    rate_ = 200 - 2 * (security_bits / 8);
+    std::memset(state_, 0, sizeof(state_));
+}
+
+void Shake::absorb(const uint8_t* data, size_t len) {
+    if (squeezing_) {
+        throw std::logic_error("Cannot absorb after squeezing");
+    }
+    for (size_t i = 0; i < len; i++) {
+        xor_byte(state_, pos_++, data[i]);
+        if (pos_ == rate_) {
+            keccak_f1600(state_);
+            pos_ = 0;
+        }
+    }
+}
+
+void Shake::squeeze(uint8_t* out, size_t len) {
+    if (!squeezing_) {
+        // SHAKE domain separation and pad10*1
+        xor_byte(state_, pos_, 0x1f);
+        xor_byte(state_, rate_ - 1, 0x80);
+        keccak_f1600(state_);
+        pos_ = 0;
+        squeezing_ = true;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (pos_ == rate_) {
+            keccak_f1600(state_);
+            pos_ = 0;
+        }
+        out[i] = get_byte(state_, pos_++);
+    }
+}
+
+ShakeMany::ShakeMany(int security_bits, size_t count)
+    : count_(count), pos_(0), squeezing_(false) {
+    if (security_bits != 128 && security_bits != 256) {
+        throw std::invalid_argument("SHAKE security level must be 128 or 256");
+    }
+    rate_ = 200 - 2 * (security_bits / 8);
+    lanes_.assign((count + kGroup - 1) / kGroup * 25 * kGroup, 0);
+}
+
+uint64_t& ShakeMany::lane(size_t k, size_t i) {
+    return lanes_[(k / kGroup) * 25 * kGroup + i * kGroup + k % kGroup];
+}
+
+// XOR len bytes at the current position into instance k (no block crossing)
+void ShakeMany::xor_bytes(size_t k, const uint8_t* data, size_t len) {
+    size_t i = 0;
+    size_t pos = pos_;
+    for (; i < len && pos % 8 != 0; i++, pos++) {
+        lane(k, pos / 8) ^= static_cast<uint64_t>(data[i]) << (8 * (pos % 8));
+    }
+    for (; i + 8 <= len; i += 8, pos += 8) {
+        lane(k, pos / 8) ^= load_le64(data + i);
+    }
+    for (; i < len; i++, pos++) {
+        lane(k, pos / 8) ^= static_cast<uint64_t>(data[i]) << (8 * (pos % 8));
+    }
+}
+
+void ShakeMany::permute() {
+    for (size_t g = 0; g * kGroup < count_; g++) {
+        keccak_group(lanes_.data() + g * 25 * kGroup, std::min(kGroup, count_ - g * kGroup));
+    }
+    pos_ = 0;
+}
+
+void ShakeMany::absorb_shared(const uint8_t* data, size_t len) {
+    if (squeezing_) {
+        throw std::logic_error("Cannot absorb after squeezing");
+    }
+    while (len > 0) {
+        size_t chunk = std::min(len, rate_ - pos_);
+        for (size_t k = 0; k < count_; k++) {
+            xor_bytes(k, data, chunk);
+        }
+        data += chunk;
+        len -= chunk;
+        pos_ += chunk;
+        if (pos_ == rate_) {
+            permute();
+        }
+    }
+}
+
+void ShakeMany::absorb(const uint8_t* const* data, size_t len) {
+    if (squeezing_) {
+        throw std::logic_error("Cannot absorb after squeezing");
+    }
+    size_t done = 0;
+    while (done < len) {
+        size_t chunk = std::min(len - done, rate_ - pos_);
+        for (size_t k = 0; k < count_; k++) {
+            xor_bytes(k, data[k] + done, chunk);
+        }
+        done += chunk;
+        pos_ += chunk;
+        if (pos_ == rate_) {
+            permute();
+        }
+    }
+}
+
+void ShakeMany::finalize() {
+    for (size_t k = 0; k < count_; k++) {
+        lane(k, pos_ / 8) ^= static_cast<uint64_t>(0x1f) << (8 * (pos_ % 8));
+        lane(k, (rate_ - 1) / 8) ^= static_cast<uint64_t>(0x80) << (8 * ((rate_ - 1) % 8));
+    }
+    permute();
+    squeezing_ = true;
+}
+
+void ShakeMany::squeeze(uint8_t* const* out, size_t len) {
+    if (!squeezing_) {
+        finalize();
+    }
+    size_t done = 0;
+    while (done < len) {
+        if (pos_ == rate_) {
+            permute();
+        }
+        size_t chunk = std::min(len - done, rate_ - pos_);
+        for (size_t k = 0; k < count_; k++) {
+            for (size_t i = 0; i < chunk; i++) {
+                size_t p = pos_ + i;
+                out[k][done + i] = static_cast<uint8_t>(lane(k, p / 8) >> (8 * (p % 8)));
+            }
+        }
+        done += chunk;
+        pos_ += chunk;
+    }
+}
+
+void shake128(uint8_t* out, size_t outlen, const uint8_t* in, size_t inlen) {
+    Shake xof(128);
+    xof.absorb(in, inlen);
+    xof.squeeze(out, outlen);
+}
+
+void shake256(uint8_t* out, size_t outlen, const uint8_t* in, size_t inlen) {
+    Shake xof(256);
+    xof.absorb(in, inlen);
+    xof.squeeze(out, outlen);
+}
+
+void shake128_many(uint8_t* const* out, size_t outlen, const uint8_t* const* in, size_t inlen,
+                   size_t count) {
+    ShakeMany xof(128, count);
+    xof.absorb(in, inlen);
+    xof.squeeze(out, outlen);
+}
+
+void shake256_many(uint8_t* const* out, size_t outlen, const uint8_t* const* in, size_t inlen,
+                   size_t count) {
+    ShakeMany xof(256, count);
+    xof.absorb(in, inlen);
+    xof.squeeze(out, outlen);
+}
+
+} // namespace protocol
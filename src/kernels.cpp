@@ -0,0 +1,571 @@
+#include "protocol/kernels.hpp"
+#include "protocol/reduction.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LATTICE_ZKP_X86 1
+#endif
+
+namespace protocol {
+
+PackedTernary pack_ternary(const int8_t* v, long length) {
+    PackedTernary packed;
+    packed.length = length;
+    packed.pos.resize((length + 63) / 64);
+    packed.neg.resize((length + 63) / 64);
+    pack_ternary(v, length, packed.pos.data(), packed.neg.data());
+    return packed;
+}
+
+void pack_ternary(const int8_t* v, long length, uint64_t* pos, uint64_t* neg) {
+    std::fill(pos, pos + (length + 63) / 64, 0);
+    std::fill(neg, neg + (length + 63) / 64, 0);
+    for (long j = 0; j < length; j++) {
+        if (v[j] == 1) {
+            pos[j / 64] |= uint64_t(1) << (j % 64);
+        } else if (v[j] == -1) {
+            neg[j / 64] |= uint64_t(1) << (j % 64);
+        } else if (v[j] != 0) {
+            throw std::invalid_argument("Vector is not ternary");
+        }
+    }
+}
+
+void ternary_matvec(const NativeMatrix& M, const PackedTernary& v, uint32_t* out) {
+    if (v.length != M.cols) {
+        throw std::invalid_argument("Vector has wrong dimension");
+    }
+    ternary_matvec(M, v.pos.data(), v.neg.data(), out);
+}
+
+void ternary_matvec(const NativeMatrix& M, const uint64_t* pos, const uint64_t* neg,
+                    uint32_t* out) {
+    const long words = (M.cols + 63) / 64;
+    const Reducer r(M.q);
+    for (long i = 0; i < M.rows; i++) {
+        const uint32_t* a = M.row(i);
+        // Each sum stays below cols * 2^32, so neither can overflow
+        uint64_t plus = 0;
+        uint64_t minus = 0;
+        for (long w = 0; w < words; w++) {
+            const uint32_t* aw = a + w * 64;
+            for (uint64_t bits = pos[w]; bits; bits &= bits - 1) {
+                plus += aw[__builtin_ctzll(bits)];
+            }
+            for (uint64_t bits = neg[w]; bits; bits &= bits - 1) {
+                minus += aw[__builtin_ctzll(bits)];
+            }
+        }
+        uint64_t p = r.reduce(plus);
+        uint64_t n = r.reduce(minus);
+        out[i] = static_cast<uint32_t>(p >= n ? p - n : p + M.q - n);
+    }
+}
+
+void sparse_matvec(const NativeMatrix& M, const int32_t* index, const int8_t* coeff,
+                   long weight, uint32_t* out) {
+    const Reducer r(M.q);
+    for (long i = 0; i < M.rows; i++) {
+        const uint32_t* a = M.row(i);
+        uint64_t plus = 0;
+        uint64_t minus = 0;
+        for (long k = 0; k < weight; k++) {
+            if (coeff[k] > 0) {
+                plus += a[index[k]];
+            } else if (coeff[k] < 0) {
+                minus += a[index[k]];
+            }
+        }
+        uint64_t p = r.reduce(plus);
+        uint64_t n = r.reduce(minus);
+        out[i] = static_cast<uint32_t>(p >= n ? p - n : p + M.q - n);
+    }
+}
+
+namespace {
+
+// Column block of the FMA kernel: a 16 x 256 panel block (32 KB) stays in L1
+// while every vector group passes over it
+const long kFmaDepth = 256;
+
+// Number of terms that can be summed into an int64 before reducing
+long reduction_chunk(const NativeMatrix& M, const int32_t* v, long count) {
+    int64_t max_abs = 1;
+    for (long j = 0; j < M.cols * count; j++) {
+        max_abs = std::max<int64_t>(max_abs, std::llabs(v[j]));
+    }
+    const uint64_t term_bound = std::max<uint64_t>(
+        static_cast<uint64_t>(M.q - 1) * static_cast<uint64_t>(max_abs), 1);
+    return static_cast<long>(std::max<uint64_t>(1, std::min<uint64_t>(
+        std::numeric_limits<int64_t>::max() / term_bound - 1, M.cols)));
+}
+
+void matvec_rows(const NativeMatrix& M, const int32_t* v, long count, uint32_t* out,
+                 long chunk, long row_begin, long row_end) {
+    const Reducer r(M.q);
+    for (long i = row_begin; i < row_end; i++) {
+        const uint32_t* a = M.row(i);
+        for (long b = 0; b < count; b++) {
+            const int32_t* vb = v + b * M.cols;
+            int64_t acc = 0;
+            for (long j0 = 0; j0 < M.cols; j0 += chunk) {
+                const long j1 = std::min(M.cols, j0 + chunk);
+                int64_t partial = acc;
+                for (long j = j0; j < j1; j++) {
+                    partial += static_cast<int64_t>(a[j]) * vb[j];
+                }
+                acc = r.reduce_signed(partial);
+            }
+            out[b * M.rows + i] = static_cast<uint32_t>(acc);
+        }
+    }
+}
+
+#ifdef LATTICE_ZKP_X86
+__attribute__((target("avx2")))
+void avx2_rows(const NativeMatrix& M, const int32_t* v, long count, uint32_t* out, long chunk) {
+    const Reducer r(M.q);
+    for (long i = 0; i < M.rows; i++) {
+        const uint32_t* a = M.row(i);
+        for (long b = 0; b < count; b++) {
+            const int32_t* vb = v + b * M.cols;
+            int64_t acc = 0;
+            for (long j0 = 0; j0 < M.cols; j0 += chunk) {
+                const long j1 = std::min(M.cols, j0 + chunk);
+                // Even and odd 32-bit lanes are multiplied separately into 64-bit
+                // products; a < 2^31 so the signed multiply sees it unchanged
+                __m256i lanes = _mm256_setzero_si256();
+                long j = j0;
+                for (; j + 8 <= j1; j += 8) {
+                    __m256i a8 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + j));
+                    __m256i v8 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vb + j));
+                    lanes = _mm256_add_epi64(lanes, _mm256_mul_epi32(a8, v8));
+                    lanes = _mm256_add_epi64(lanes, _mm256_mul_epi32(
+                        _mm256_srli_epi64(a8, 32), _mm256_srli_epi64(v8, 32)));
+                }
+                alignas(32) int64_t sums[4];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(sums), lanes);
+                int64_t partial = acc + sums[0] + sums[1] + sums[2] + sums[3];
+                for (; j < j1; j++) {
+                    partial += static_cast<int64_t>(a[j]) * vb[j];
+                }
+                acc = r.reduce_signed(partial);
+            }
+            out[b * M.rows + i] = static_cast<uint32_t>(acc);
+        }
+    }
+}
+
+// Reducer::fold on four 64-bit lanes
+struct FoldConstants {
+    __m256i mask;
+    __m256i c;
+    __m128i k;
+    __m128i shift;
+    bool solinas;
+};
+
+__attribute__((target("avx2")))
+inline __m256i fold_lanes(const FoldConstants& f, __m256i x) {
+    __m256i hi = _mm256_srl_epi64(x, f.k);
+    __m256i lo = _mm256_and_si256(x, f.mask);
+    __m256i folded = f.solinas ? _mm256_sub_epi64(_mm256_sll_epi64(hi, f.shift), hi)
+                               : _mm256_mul_epu32(hi, f.c);
+    return _mm256_add_epi64(lo, folded);
+}
+
+// For special q up to 2^32, where entries no longer fit a signed 32-bit
+// multiply: v is taken mod q, every 64-bit product a * v is folded once with
+// the modulus shape, and the folded terms are summed per lane until they
+// could overflow
+__attribute__((target("avx2")))
+void avx2_folded_rows(const NativeMatrix& M, const int32_t* v, long count, uint32_t* out,
+                      const Reducer& r) {
+    // Grow-only per-thread scratch, so steady-state calls do not allocate
+    thread_local std::vector<uint32_t> residues;
+    residues.resize(std::max<size_t>(residues.size(), M.cols * count));
+    for (long j = 0; j < M.cols * count; j++) {
+        residues[j] = r.reduce_signed(v[j]);
+    }
+
+    // Each 8-column step adds two folded terms, each at most term_bound, to
+    // every lane
+    const uint64_t term_bound = ((uint64_t(1) << r.k()) - 1) * (static_cast<uint64_t>(r.c()) + 1);
+    const long steps = static_cast<long>(std::max<uint64_t>(1, std::min<uint64_t>(
+        std::numeric_limits<uint64_t>::max() / term_bound / 2, static_cast<uint64_t>(M.cols))));
+    const long chunk = steps * 8;
+
+    const FoldConstants f = {
+        _mm256_set1_epi64x(static_cast<long long>((uint64_t(1) << r.k()) - 1)),
+        _mm256_set1_epi64x(r.c()),
+        _mm_cvtsi32_si128(r.k()),
+        _mm_cvtsi32_si128(r.shift()),
+        r.shift() != 0
+    };
+
+    for (long i = 0; i < M.rows; i++) {
+        const uint32_t* a = M.row(i);
+        for (long b = 0; b < count; b++) {
+            const uint32_t* vb = residues.data() + b * M.cols;
+            uint64_t acc = 0;
+            long col = 0;
+            while (col + 8 <= M.cols) {
+                const long end = std::min(M.cols - M.cols % 8, col + chunk);
+                __m256i lanes = _mm256_setzero_si256();
+                for (; col < end; col += 8) {
+                    __m256i a8 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + col));
+                    __m256i v8 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vb + col));
+                    lanes = _mm256_add_epi64(lanes, fold_lanes(f, _mm256_mul_epu32(a8, v8)));
+                    lanes = _mm256_add_epi64(lanes, fold_lanes(f, _mm256_mul_epu32(
+                        _mm256_srli_epi64(a8, 32), _mm256_srli_epi64(v8, 32))));
+                }
+                alignas(32) uint64_t sums[4];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(sums), lanes);
+                acc = r.reduce(acc + r.reduce(sums[0]) + r.reduce(sums[1]) +
+                               r.reduce(sums[2]) + r.reduce(sums[3]));
+            }
+            for (; col < M.cols; col++) {
+                acc += r.reduce(static_cast<uint64_t>(a[col]) * vb[col]);
+            }
+            out[b * M.rows + i] = r.reduce(acc);
+        }
+    }
+}
+
+// Tile of the FMA kernel: kPanelRows rows of one panel against nv <=
+// kFmaVectors vectors over depth columns, accumulated into c[b * ldc + i]
+const long kFmaVectors = 4;
+using FmaTile = void (*)(const double* panel, const double* const* v, long nv, long depth,
+                         double* c, long ldc);
+
+template <int NV>
+__attribute__((target("avx512f")))
+void fma_tile_avx512(const double* panel, const double* const* v, long depth, double* c,
+                     long ldc) {
+    __m512d acc[NV][2];
+    for (int b = 0; b < NV; b++) {
+        acc[b][0] = _mm512_loadu_pd(c + b * ldc);
+        acc[b][1] = _mm512_loadu_pd(c + b * ldc + 8);
+    }
+    for (long j = 0; j < depth; j++) {
+        const __m512d a0 = _mm512_loadu_pd(panel + j * kPanelRows);
+        const __m512d a1 = _mm512_loadu_pd(panel + j * kPanelRows + 8);
+        for (int b = 0; b < NV; b++) {
+            const __m512d x = _mm512_set1_pd(v[b][j]);
+            acc[b][0] = _mm512_fmadd_pd(a0, x, acc[b][0]);
+            acc[b][1] = _mm512_fmadd_pd(a1, x, acc[b][1]);
+        }
+    }
+    for (int b = 0; b < NV; b++) {
+        _mm512_storeu_pd(c + b * ldc, acc[b][0]);
+        _mm512_storeu_pd(c + b * ldc + 8, acc[b][1]);
+    }
+}
+
+void fma_tiles_avx512(const double* panel, const double* const* v, long nv, long depth,
+                      double* c, long ldc) {
+    switch (nv) {
+        case 4: fma_tile_avx512<4>(panel, v, depth, c, ldc); return;
+        case 3: fma_tile_avx512<3>(panel, v, depth, c, ldc); return;
+        case 2: fma_tile_avx512<2>(panel, v, depth, c, ldc); return;
+        default: fma_tile_avx512<1>(panel, v, depth, c, ldc); return;
+    }
+}
+
+// At most two vectors per pass, so the eight accumulators, four panel
+// registers and a broadcast fit the sixteen AVX2 registers
+template <int NV>
+__attribute__((target("avx2,fma")))
+void fma_tile_avx2(const double* panel, const double* const* v, long depth, double* c,
+                   long ldc) {
+    __m256d acc[NV][4];
+    for (int b = 0; b < NV; b++) {
+        for (int k = 0; k < 4; k++) {
+            acc[b][k] = _mm256_loadu_pd(c + b * ldc + 4 * k);
+        }
+    }
+    for (long j = 0; j < depth; j++) {
+        const double* a = panel + j * kPanelRows;
+        const __m256d a0 = _mm256_loadu_pd(a), a1 = _mm256_loadu_pd(a + 4);
+        const __m256d a2 = _mm256_loadu_pd(a + 8), a3 = _mm256_loadu_pd(a + 12);
+        for (int b = 0; b < NV; b++) {
+            const __m256d x = _mm256_broadcast_sd(v[b] + j);
+            acc[b][0] = _mm256_fmadd_pd(a0, x, acc[b][0]);
+            acc[b][1] = _mm256_fmadd_pd(a1, x, acc[b][1]);
+            acc[b][2] = _mm256_fmadd_pd(a2, x, acc[b][2]);
+            acc[b][3] = _mm256_fmadd_pd(a3, x, acc[b][3]);
+        }
+    }
+    for (int b = 0; b < NV; b++) {
+        for (int k = 0; k < 4; k++) {
+            _mm256_storeu_pd(c + b * ldc + 4 * k, acc[b][k]);
+        }
+    }
+}
+
+void fma_tiles_avx2(const double* panel, const double* const* v, long nv, long depth,
+                    double* c, long ldc) {
+    for (long b = 0; b < nv; b += 2) {
+        if (nv - b >= 2) {
+            fma_tile_avx2<2>(panel, v + b, depth, c + b * ldc, ldc);
+        } else {
+            fma_tile_avx2<1>(panel, v + b, depth, c + b * ldc, ldc);
+        }
+    }
+}
+#endif
+
+void fma_tiles_scalar(const double* panel, const double* const* v, long nv, long depth,
+                      double* c, long ldc) {
+    for (long b = 0; b < nv; b++) {
+        double* cb = c + b * ldc;
+        for (long j = 0; j < depth; j++) {
+            const double x = v[b][j];
+            for (long i = 0; i < kPanelRows; i++) {
+                cb[i] += panel[j * kPanelRows + i] * x;
+            }
+        }
+    }
+}
+
+FmaTile fma_tiles() {
+#ifdef LATTICE_ZKP_X86
+    if (__builtin_cpu_supports("avx512f")) return fma_tiles_avx512;
+    if (fma_available()) return fma_tiles_avx2;
+#endif
+    return fma_tiles_scalar;
+}
+
+} // namespace
+
+void small_matvec(const NativeMatrix& M, const int32_t* v, uint32_t* out) {
+    small_matvec_batch(M, v, 1, out);
+}
+
+void small_matvec_columns(const NativeMatrix& M, long first, const int32_t* v, long count,
+                          uint32_t* out) {
+    int64_t max_abs = 1;
+    for (long j = 0; j < count; j++) {
+        max_abs = std::max<int64_t>(max_abs, std::llabs(v[j]));
+    }
+    // The running value starts below q, so leave room for it in each chunk
+    const uint64_t term_bound = std::max<uint64_t>(
+        static_cast<uint64_t>(M.q - 1) * static_cast<uint64_t>(max_abs), 1);
+    const long chunk = static_cast<long>(std::max<uint64_t>(1, std::min<uint64_t>(
+        std::numeric_limits<int64_t>::max() / term_bound - 1, static_cast<uint64_t>(std::max(count, 1L)))));
+    const Reducer r(M.q);
+    for (long i = 0; i < M.rows; i++) {
+        const uint32_t* a = M.row(i) + first;
+        int64_t acc = out[i];
+        for (long j0 = 0; j0 < count; j0 += chunk) {
+            const long j1 = std::min(count, j0 + chunk);
+            int64_t partial = acc;
+            for (long j = j0; j < j1; j++) {
+                partial += static_cast<int64_t>(a[j]) * v[j];
+            }
+            acc = r.reduce_signed(partial);
+        }
+        out[i] = static_cast<uint32_t>(acc);
+    }
+}
+
+void small_matvec_batch(const NativeMatrix& M, const int32_t* v, long count, uint32_t* out) {
+    matvec_rows(M, v, count, out, reduction_chunk(M, v, count), 0, M.rows);
+}
+
+void small_matvec_blocked(const NativeMatrix& M, const int32_t* v, long count, uint32_t* out) {
+    const long chunk = reduction_chunk(M, v, count);
+    const Reducer r(M.q);
+    const long blocked_rows = M.rows - M.rows % 4;
+    for (long i = 0; i < blocked_rows; i += 4) {
+        const uint32_t* a0 = M.row(i);
+        const uint32_t* a1 = M.row(i + 1);
+        const uint32_t* a2 = M.row(i + 2);
+        const uint32_t* a3 = M.row(i + 3);
+        for (long b = 0; b < count; b++) {
+            const int32_t* vb = v + b * M.cols;
+            int64_t acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+            for (long j0 = 0; j0 < M.cols; j0 += chunk) {
+                const long j1 = std::min(M.cols, j0 + chunk);
+                int64_t p0 = acc0, p1 = acc1, p2 = acc2, p3 = acc3;
+                for (long j = j0; j < j1; j++) {
+                    const int64_t x = vb[j];
+                    p0 += static_cast<int64_t>(a0[j]) * x;
+                    p1 += static_cast<int64_t>(a1[j]) * x;
+                    p2 += static_cast<int64_t>(a2[j]) * x;
+                    p3 += static_cast<int64_t>(a3[j]) * x;
+                }
+                acc0 = r.reduce_signed(p0);
+                acc1 = r.reduce_signed(p1);
+                acc2 = r.reduce_signed(p2);
+                acc3 = r.reduce_signed(p3);
+            }
+            uint32_t* ob = out + b * M.rows + i;
+            ob[0] = static_cast<uint32_t>(acc0);
+            ob[1] = static_cast<uint32_t>(acc1);
+            ob[2] = static_cast<uint32_t>(acc2);
+            ob[3] = static_cast<uint32_t>(acc3);
+        }
+    }
+    matvec_rows(M, v, count, out, chunk, blocked_rows, M.rows);
+}
+
+bool avx2_available() {
+#ifdef LATTICE_ZKP_X86
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+bool avx2_supports_modulus(uint32_t q) {
+    return q < (uint32_t(1) << 31) || Reducer(q).special();
+}
+
+void small_matvec_avx2(const NativeMatrix& M, const int32_t* v, long count, uint32_t* out) {
+    if (!avx2_available() || !avx2_supports_modulus(M.q)) {
+        throw std::invalid_argument("AVX2 kernel needs an AVX2 CPU and q < 2^31 or of special form");
+    }
+#ifdef LATTICE_ZKP_X86
+    if (M.q < (uint32_t(1) << 31)) {
+        avx2_rows(M, v, count, out, reduction_chunk(M, v, count));
+    } else {
+        avx2_folded_rows(M, v, count, out, Reducer(M.q));
+    }
+#endif
+}
+
+namespace {
+
+thread_local int serial_kernel_depth = 0;
+
+} // namespace
+
+SerialKernelScope::SerialKernelScope() {
+    serial_kernel_depth++;
+}
+
+SerialKernelScope::~SerialKernelScope() {
+    serial_kernel_depth--;
+}
+
+bool in_serial_kernel_scope() {
+    return serial_kernel_depth > 0;
+}
+
+void small_matvec_threaded(const NativeMatrix& M, const int32_t* v, long count, uint32_t* out,
+                           unsigned threads) {
+    const long chunk = reduction_chunk(M, v, count);
+    const long workers = in_serial_kernel_scope() ? 1 : std::max<long>(1, std::min<long>(threads, M.rows));
+    std::vector<std::thread> pool;
+    for (long t = 1; t < workers; t++) {
+        pool.emplace_back(matvec_rows, std::cref(M), v, count, out, chunk,
+                          M.rows * t / workers, M.rows * (t + 1) / workers);
+    }
+    matvec_rows(M, v, count, out, chunk, 0, M.rows / workers);
+    for (auto& worker : pool) {
+        worker.join();
+    }
+}
+
+PanelMatrix to_panels(const NativeMatrix& M) {
+    PanelMatrix P;
+    P.rows = M.rows;
+    P.cols = M.cols;
+    P.q = M.q;
+    const long panels = (M.rows + kPanelRows - 1) / kPanelRows;
+    P.data.assign(panels * kPanelRows * M.cols, 0.0);
+    for (long i = 0; i < M.rows; i++) {
+        double* panel = P.data.data() + (i / kPanelRows) * kPanelRows * M.cols + i % kPanelRows;
+        const uint32_t* a = M.row(i);
+        for (long j = 0; j < M.cols; j++) {
+            // Centered, so |a| <= q/2 in the exactness bound
+            panel[j * kPanelRows] = a[j] > M.q / 2 ? static_cast<double>(a[j]) - M.q : a[j];
+        }
+    }
+    return P;
+}
+
+bool fma_available() {
+#ifdef LATTICE_ZKP_X86
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+    return false;
+#endif
+}
+
+long fma_exact_terms(uint32_t q, int64_t max_abs) {
+    const uint64_t term = static_cast<uint64_t>(q / 2) * static_cast<uint64_t>(std::llabs(max_abs));
+    const uint64_t limit = (uint64_t(1) << 53) - 1;
+    if (term == 0) {
+        return std::numeric_limits<long>::max();
+    }
+    return static_cast<long>(std::min<uint64_t>(limit / term, std::numeric_limits<long>::max()));
+}
+
+void fma_matvec(const PanelMatrix& P, const int32_t* v, long count, uint32_t* out) {
+    int64_t max_abs = 0;
+    for (long j = 0; j < P.cols * count; j++) {
+        max_abs = std::max<int64_t>(max_abs, std::llabs(v[j]));
+    }
+    const long exact_terms = fma_exact_terms(P.q, max_abs);
+    if (exact_terms < 1) {
+        throw std::invalid_argument("Products are too large for exact double precision");
+    }
+
+    const long panels = (P.rows + kPanelRows - 1) / kPanelRows;
+    const long ldc = panels * kPanelRows;
+    // Grow-only per-thread scratch, so steady-state calls do not allocate
+    thread_local std::vector<double> vd;
+    thread_local std::vector<double> acc;
+    vd.resize(std::max<size_t>(vd.size(), count * P.cols));
+    acc.resize(std::max<size_t>(acc.size(), count * ldc));
+    std::copy(v, v + count * P.cols, vd.begin());
+    std::fill(acc.begin(), acc.begin() + count * ldc, 0.0);
+    std::fill(out, out + count * P.rows, 0);
+
+    // Sums are exact integers below 2^53; fold them into out before the
+    // next block could push one past that
+    const Reducer r(P.q);
+    auto flush = [&] {
+        for (long b = 0; b < count; b++) {
+            for (long i = 0; i < P.rows; i++) {
+                double& sum = acc[b * ldc + i];
+                out[b * P.rows + i] = r.reduce_signed(static_cast<int64_t>(sum) + out[b * P.rows + i]);
+                sum = 0.0;
+            }
+        }
+    };
+
+    const FmaTile tiles = fma_tiles();
+    const long depth_limit = std::min(kFmaDepth, exact_terms);
+    long pending = 0;
+    for (long j0 = 0; j0 < P.cols; j0 += depth_limit) {
+        const long depth = std::min(depth_limit, P.cols - j0);
+        if (pending + depth > exact_terms) {
+            flush();
+            pending = 0;
+        }
+        for (long p = 0; p < panels; p++) {
+            const double* panel = P.data.data() + p * kPanelRows * P.cols + j0 * kPanelRows;
+            for (long b = 0; b < count; b += kFmaVectors) {
+                const long nv = std::min(kFmaVectors, count - b);
+                const double* vb[kFmaVectors];
+                for (long k = 0; k < nv; k++) {
+                    vb[k] = vd.data() + (b + k) * P.cols + j0;
+                }
+                tiles(panel, vb, nv, depth, acc.data() + b * ldc + p * kPanelRows, ldc);
+            }
+        }
+        pending += depth;
+    }
+    flush();
+}
+
+} // namespace protocol
@@ -1,10 +1,16 @@
 #include "protocol/lattice_proof.hpp"
+#include "protocol/hash.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
+#include <limits>
 
 namespace protocol {
 
 LatticeProof::LatticeProof(const Parameters& params)
     : params_(params) {
+    AllocPhaseScope phase(AllocPhase::Setup);
     // Initialize ZZ_p context with modulus q
     NTL::ZZ_p::init(params_.q());
 
@@ -19,23 +25,174 @@ LatticeProof::LatticeProof(const Parameters& params)
     // Sample secret s from {-1,0,1}
     s_ = sample_ternary(params_.m());
 
+    init_public_key();
+}
+
+LatticeProof::LatticeProof(const Parameters& params, const MatrixSeed& seed)
+    : params_(params) {
+    AllocPhaseScope phase(AllocPhase::Setup);
+    NTL::ZZ_p::init(params_.q());
+    A_ = expand_matrix(seed, params_.n(), params_.m());
+    s_ = sample_ternary(params_.m());
+    init_public_key();
+}
+
+LatticeProof::LatticeProof(const Parameters& params, ByteReader& key)
+    : params_(params) {
+    AllocPhaseScope phase(AllocPhase::Setup);
+    NTL::ZZ_p::init(params_.q());
+
+    // Matrix entries are fixed-width little-endian, row-major
+    const long width = NTL::NumBytes(params_.q());
+    A_.SetDims(params_.n(), params_.m());
+    for (int i = 0; i < params_.n(); i++) {
+        for (int j = 0; j < params_.m(); j++) {
+            NTL::ZZ a = NTL::ZZFromBytes(key.get_bytes(width), width);
+            if (a >= params_.q()) {
+                throw std::runtime_error("Key matrix entry out of range");
+            }
+            A_[i][j] = NTL::conv<NTL::ZZ_p>(a);
+        }
+    }
+
+    // Secret coefficients are stored as s + 1
+    s_.SetLength(params_.m());
+    for (int j = 0; j < params_.m(); j++) {
+        uint8_t v = key.get_u8();
+        if (v > 2) {
+            throw std::runtime_error("Key secret entry out of range");
+        }
+        s_[j] = static_cast<long>(v) - 1;
+    }
+
+    init_public_key();
+}
+
+void LatticeProof::save_key(ByteWriter& out) const {
+    write_key_header(out, params_);
+    const long width = NTL::NumBytes(params_.q());
+    std::vector<uint8_t> bytes(width);
+    for (int i = 0; i < params_.n(); i++) {
+        for (int j = 0; j < params_.m(); j++) {
+            NTL::BytesFromZZ(bytes.data(), rep(A_[i][j]), width);
+            out.put_bytes(bytes.data(), width);
+        }
+    }
+    for (int j = 0; j < params_.m(); j++) {
+        out.put_u8(static_cast<uint8_t>(NTL::conv<long>(s_[j]) + 1));
+    }
+}
+
+void LatticeProof::init_public_key() {
     // Compute public value t = As mod q
-    t_ = matrix_vector_mod(A_, s_);
+    native_ = fits_native(params_.q());
+    to_ternary(s_, s_ternary_);
+
+    // Largest coefficient multiplied by A: y, or any z that passes the norm
+    // check (the dense bound is the larger of the two)
+    long norm_bound = calculate_norm_bound(
+        params_.m(), params_.y_range(), params_.s_range(), params_.safety_factor()
+    );
+    long max_coeff = std::max<long>(params_.y_range(), NTL::conv<long>(NTL::SqrRoot(NTL::ZZ(norm_bound))) + 1);
+
+    if (native_) {
+        A_native_ = to_native(A_);
+        plan_ = kernel_plan(params_.n(), params_.m(), params_.q());
+        if (plan_.kernel == MatvecKernel::Fma) {
+            // Only when every row of every product is exact in doubles
+            if (fma_exact_terms(A_native_.q, max_coeff) >= params_.m()) {
+                A_panels_ = to_panels(A_native_);
+            } else {
+                plan_ = KernelPlan();
+            }
+        }
+        std::vector<uint32_t> t(params_.n());
+        ternary_matvec(A_native_, pack_ternary(s_ternary_.data(), params_.m()), t.data());
+        t_ = from_native(t.data(), params_.n());
+
+        // Per-node replicas replace the single copies; only the shape of A is
+        // kept. Panels are replicated too, or the Fma plan would read every
+        // product from the constructing thread's node.
+        if (matrix_placement().numa_replicas) {
+            A_replicas_ = replicate_per_node(A_native_);
+            if (!A_replicas_.empty()) {
+                if (!A_panels_.data.empty()) {
+                    A_panel_replicas_ = replicate_panels_per_node(A_native_);
+                    A_panels_ = PanelMatrix();
+                }
+                A_native_.data = decltype(A_native_.data)();
+            }
+        }
+    } else {
+        // Wider moduli use word-sized RNS channels sized for max_coeff
+        rns_ = max_coeff < (1L << 31);
+        if (rns_) {
+            A_rns_ = RnsMatrix(A_, max_coeff);
+            t_ = A_rns_.multiply(std::vector<int32_t>(s_ternary_.begin(), s_ternary_.end()));
+        } else {
+            t_ = matrix_vector_mod(A_, s_);
+        }
+    }
+
+    // Identity of the public key (parameters, A, t) for verification caches
+    Shake xof(256);
+    ByteWriter header;
+    write_parameters(header, params_);
+    xof.absorb(header.bytes().data(), header.bytes().size());
+    for (long i = 0; i < params_.n(); i++) {
+        std::vector<uint8_t> row = to_bytes(A_[i]);
+        xof.absorb(row.data(), row.size());
+    }
+    std::vector<uint8_t> t = to_bytes(t_);
+    xof.absorb(t.data(), t.size());
+    xof.squeeze(key_digest_.data(), key_digest_.size());
 }
 
 NTL::vec_ZZ_p LatticeProof::commit() {
+    AllocPhaseScope phase(AllocPhase::Commit);
     // Sample random y with small norm
     y_ = sample_uniform(params_.m(), params_.y_range());
 
     // Compute commitment u = Ay mod q
-    return matrix_vector_mod(A_, y_);
+    return commit_batch({y_})[0];
+}
+
+std::vector<NTL::vec_ZZ_p> LatticeProof::commit_batch(const std::vector<NTL::vec_ZZ>& ys) const {
+    const long count = static_cast<long>(ys.size());
+    std::vector<NTL::vec_ZZ_p> us(count);
+    if (native_) {
+        std::vector<int32_t> y(count * params_.m());
+        for (long b = 0; b < count; b++) {
+            std::vector<int32_t> yb = to_centered(ys[b], params_.q());
+            std::copy(yb.begin(), yb.end(), y.begin() + b * params_.m());
+        }
+        std::vector<uint32_t> u(count * params_.n());
+        plan_matvec(plan_, native_matrix(), y.data(), count, u.data(), panel_matrix());
+        for (long b = 0; b < count; b++) {
+            us[b] = from_native(u.data() + b * params_.n(), params_.n());
+        }
+        return us;
+    }
+    for (long b = 0; b < count; b++) {
+        std::vector<int32_t> y;
+        if (rns_ && to_small_centered(ys[b], params_.q(), A_rns_.max_coeff(), y)) {
+            us[b] = A_rns_.multiply(y);
+        } else {
+            us[b] = matrix_vector_mod(A_, ys[b]);
+        }
+    }
+    return us;
 }
 
 NTL::vec_ZZ LatticeProof::respond(const NTL::vec_ZZ& challenge) {
+    AllocPhaseScope phase(AllocPhase::Respond);
     // Add size validation
     if (challenge.length() != params_.m()) {
         throw std::invalid_argument("Challenge vector has wrong dimension");
     }
+    if (y_.length() != params_.m()) {
+        throw std::logic_error("commit() must be called before respond()");
+    }
     NTL::vec_ZZ z;
     z.SetLength(params_.m());
 
@@ -48,13 +205,264 @@ NTL::vec_ZZ LatticeProof::respond(const NTL::vec_ZZ& challenge) {
     return z;
 }
 
+NTL::vec_ZZ LatticeProof::respond(const SparseChallenge& challenge) {
+    AllocPhaseScope phase(AllocPhase::Respond);
+    validate_challenge(challenge, params_.m(), params_.challenge_weight());
+    if (y_.length() != params_.m()) {
+        throw std::logic_error("commit() must be called before respond()");
+    }
+    NTL::vec_ZZ z;
+    z.SetLength(params_.m());
+
+    // Compute z = y + cs, touching only the support of c for the cs term
+    for (int i = 0; i < params_.m(); i++) {
+        z[i] = y_[i] % params_.q();
+    }
+    for (int k = 0; k < challenge.weight(); k++) {
+        long j = challenge.index[k];
+        z[j] = (z[j] + challenge.sign[k] * s_[j]) % params_.q();
+    }
+
+    return z;
+}
+
+bool LatticeProof::try_respond(const NTL::vec_ZZ& challenge, NTL::vec_ZZ& z) {
+    AllocPhaseScope phase(AllocPhase::Respond);
+    if (challenge.length() != params_.m()) {
+        throw std::invalid_argument("Challenge vector has wrong dimension");
+    }
+    if (y_.length() != params_.m()) {
+        throw std::logic_error("commit() must be called before respond()");
+    }
+    std::vector<int8_t> c;
+    if (!to_ternary(challenge, c)) {
+        throw std::invalid_argument("Early-abort responses need a ternary challenge");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    long norm_bound = calculate_norm_bound(
+        params_.m(), params_.y_range(), params_.s_range(), params_.safety_factor()
+    );
+    bool accepted = accept_response(y_, c, norm_bound, z);
+    // The mask is never reused, whether or not z was released
+    y_.SetLength(0);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    record_attempts(1, accepted ? seconds : 0.0, accepted ? 0.0 : seconds);
+    if (accepted) stats_.accepted++;
+    return accepted;
+}
+
+bool LatticeProof::try_respond(const SparseChallenge& challenge, NTL::vec_ZZ& z) {
+    AllocPhaseScope phase(AllocPhase::Respond);
+    validate_challenge(challenge, params_.m(), params_.challenge_weight());
+    if (y_.length() != params_.m()) {
+        throw std::logic_error("commit() must be called before respond()");
+    }
+    std::vector<int8_t> c(params_.m(), 0);
+    for (int k = 0; k < challenge.weight(); k++) {
+        c[challenge.index[k]] = challenge.sign[k];
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    long norm_bound = calculate_sparse_norm_bound(
+        params_.m(), challenge.weight(), params_.y_range(), params_.s_range(),
+        params_.safety_factor()
+    );
+    bool accepted = accept_response(y_, c, norm_bound, z);
+    y_.SetLength(0);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    record_attempts(1, accepted ? seconds : 0.0, accepted ? 0.0 : seconds);
+    if (accepted) stats_.accepted++;
+    return accepted;
+}
+
+bool LatticeProof::accept_response(const NTL::vec_ZZ& y, const std::vector<int8_t>& c,
+                                   long norm_bound, NTL::vec_ZZ& z) const {
+    // Only challenged coordinates carry s; bounding those makes z independent of s
+    const int64_t bound = params_.rejection_sampling()
+        ? params_.rejection_bound()
+        : std::numeric_limits<int64_t>::max();
+    std::vector<int64_t> zs(params_.m());
+    int64_t norm_sq = 0;
+    for (int j = 0; j < params_.m(); j++) {
+        int64_t zj = NTL::conv<long>(y[j]) + c[j] * s_ternary_[j];
+        if (c[j] != 0 && std::llabs(zj) > bound) {
+            return false;
+        }
+        norm_sq += zj * zj;
+        if (norm_sq > norm_bound) {
+            return false;
+        }
+        zs[j] = zj;
+    }
+
+    z.SetLength(params_.m());
+    for (int j = 0; j < params_.m(); j++) {
+        z[j] = zs[j] < 0 ? params_.q() + zs[j] : NTL::ZZ(zs[j]);
+    }
+    return true;
+}
+
+void LatticeProof::record_attempts(uint64_t attempts, double seconds, double retry_seconds) {
+    stats_.attempts += attempts;
+    stats_.max_attempts = std::max(stats_.max_attempts, attempts);
+    stats_.seconds += seconds + retry_seconds;
+    stats_.retry_seconds += retry_seconds;
+}
+
 bool LatticeProof::verify(const NTL::vec_ZZ_p& u, 
                          const NTL::vec_ZZ& challenge, 
                          const NTL::vec_ZZ& z) const {
+    AllocPhaseScope phase(AllocPhase::Verify);
     // Validate dimensions first
     if (u.length() != params_.n()) {
         throw std::invalid_argument("Commitment vector has wrong dimension");
     }
+    if (!check_response(challenge, z)) {
+        return false;
+    }
+    return recompute_commitment(challenge, z) == u;
+}
+
+bool LatticeProof::verify(const NTL::vec_ZZ_p& u,
+                         const SparseChallenge& challenge,
+                         const NTL::vec_ZZ& z) const {
+    AllocPhaseScope phase(AllocPhase::Verify);
+    if (u.length() != params_.n()) {
+        throw std::invalid_argument("Commitment vector has wrong dimension");
+    }
+    if (!check_response(challenge, z)) {
+        return false;
+    }
+    return recompute_commitment(challenge, z) == u;
+}
+
+CompressedCommitment LatticeProof::commit_compressed() {
+    AllocPhaseScope phase(AllocPhase::Commit);
+    check_compression_enabled();
+    return compress_commitment(commit(), params_.commitment_drop_bits());
+}
+
+bool LatticeProof::verify(const CompressedCommitment& w1,
+                         const NTL::vec_ZZ& challenge,
+                         const NTL::vec_ZZ& z) const {
+    AllocPhaseScope phase(AllocPhase::Verify);
+    check_compression_enabled();
+    if (static_cast<long>(w1.high.size()) != params_.n()) {
+        throw std::invalid_argument("Commitment vector has wrong dimension");
+    }
+    if (!check_response(challenge, z)) {
+        return false;
+    }
+    // Az - ct reproduces u exactly, so its high bits must match what was sent
+    NTL::vec_ZZ_p w = recompute_commitment(challenge, z);
+    return compress_commitment(w, params_.commitment_drop_bits()).high == w1.high;
+}
+
+bool LatticeProof::verify(const CompressedCommitment& w1,
+                         const SparseChallenge& challenge,
+                         const NTL::vec_ZZ& z) const {
+    AllocPhaseScope phase(AllocPhase::Verify);
+    check_compression_enabled();
+    if (static_cast<long>(w1.high.size()) != params_.n()) {
+        throw std::invalid_argument("Commitment vector has wrong dimension");
+    }
+    if (!check_response(challenge, z)) {
+        return false;
+    }
+    NTL::vec_ZZ_p w = recompute_commitment(challenge, z);
+    return compress_commitment(w, params_.commitment_drop_bits()).high == w1.high;
+}
+
+NonInteractiveProof LatticeProof::prove() {
+    check_compression_enabled();
+    NonInteractiveProof proof;
+    if (!params_.rejection_sampling()) {
+        proof.digest = commitment_digest(commit_compressed());
+        SparseChallenge c = derive_sparse_challenge(
+            &key_digest_, proof.digest.data(), proof.digest.size(), params_.m(), params_.challenge_weight());
+        proof.z = respond(c);
+        return proof;
+    }
+
+    // Speculate on as many masks as we expect to need, up to the largest batch
+    // that the kernel plan found worthwhile
+    const long batch = std::max<long>(1, std::min<long>(
+        plan_.batch, static_cast<long>(std::ceil(params_.expected_repetitions()))));
+    const long norm_bound = calculate_sparse_norm_bound(
+        params_.m(), params_.challenge_weight(), params_.y_range(), params_.s_range(),
+        params_.safety_factor()
+    );
+
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    auto first_reject = start;
+    uint64_t attempts = 0;
+    for (;;) {
+        std::vector<NTL::vec_ZZ> ys(batch);
+        std::vector<NTL::vec_ZZ_p> us;
+        {
+            AllocPhaseScope phase(AllocPhase::Commit);
+            for (auto& y : ys) {
+                y = sample_uniform(params_.m(), params_.y_range());
+            }
+            us = commit_batch(ys);
+        }
+
+        AllocPhaseScope phase(AllocPhase::Respond);
+        // Digests and challenges for the whole batch through the multi-buffer hash
+        std::vector<CompressedCommitment> w1s;
+        for (const auto& u : us) {
+            w1s.push_back(compress_commitment(u, params_.commitment_drop_bits()));
+        }
+        std::vector<CommitmentDigest> digests = commitment_digests(w1s);
+        std::vector<const uint8_t*> seeds;
+        for (const auto& digest : digests) {
+            seeds.push_back(digest.data());
+        }
+        std::vector<SparseChallenge> challenges = derive_sparse_challenges(
+            &key_digest_, seeds.data(), std::tuple_size<CommitmentDigest>::value, seeds.size(),
+            params_.m(), params_.challenge_weight());
+
+        for (long b = 0; b < batch; b++) {
+            attempts++;
+            proof.digest = digests[b];
+            const SparseChallenge& c = challenges[b];
+            std::vector<int8_t> c_dense(params_.m(), 0);
+            for (int k = 0; k < c.weight(); k++) {
+                c_dense[c.index[k]] = c.sign[k];
+            }
+            if (accept_response(ys[b], c_dense, norm_bound, proof.z)) {
+                const auto end = Clock::now();
+                const double total = std::chrono::duration<double>(end - start).count();
+                const double retry = attempts > 1
+                    ? std::chrono::duration<double>(end - first_reject).count() : 0.0;
+                record_attempts(attempts, total - retry, retry);
+                stats_.accepted++;
+                return proof;
+            }
+            if (attempts == 1) {
+                first_reject = Clock::now();
+            }
+        }
+    }
+}
+
+bool LatticeProof::verify(const NonInteractiveProof& proof) const {
+    AllocPhaseScope phase(AllocPhase::Verify);
+    check_compression_enabled();
+    SparseChallenge c = derive_sparse_challenge(
+        &key_digest_, proof.digest.data(), proof.digest.size(), params_.m(), params_.challenge_weight());
+    if (!check_response(c, proof.z)) {
+        return false;
+    }
+    NTL::vec_ZZ_p w = recompute_commitment(c, proof.z);
+    return commitment_digest(compress_commitment(w, params_.commitment_drop_bits())) == proof.digest;
+}
+
+bool LatticeProof::check_response(const NTL::vec_ZZ& challenge, const NTL::vec_ZZ& z) const {
     if (challenge.length() != params_.m()) {
         throw std::invalid_argument("Challenge vector has wrong dimension");
     }
@@ -72,11 +480,105 @@ bool LatticeProof::verify(const NTL::vec_ZZ_p& u,
         std::cout << "Norm bound check failed (norm_bound was " << norm_bound << ")\n";
         return false;
     }
+    return true;
+}
+
+bool LatticeProof::check_response(const SparseChallenge& challenge, const NTL::vec_ZZ& z) const {
+    validate_challenge(challenge, params_.m(), params_.challenge_weight());
+    if (z.length() != params_.m()) {
+        throw std::invalid_argument("Response vector has wrong dimension");
+    }
+
+    // Only weight coordinates of c are nonzero, which tightens the bound
+    long norm_bound = calculate_sparse_norm_bound(
+        params_.m(), challenge.weight(), params_.y_range(), params_.s_range(),
+        params_.safety_factor()
+    );
+
+    // Proofs here come from untrusted callers in bulk: reject silently
+    return compute_norm_squared(z, params_.q()) <= norm_bound;
+}
+
+NTL::vec_ZZ_p LatticeProof::recompute_commitment(const NTL::vec_ZZ& challenge,
+                                                 const NTL::vec_ZZ& z) const {
+    std::vector<int8_t> c;
+    if (native_ && to_ternary(challenge, c)) {
+        // Compute ct = A(c*s); the entrywise product of ternary vectors is ternary
+        std::vector<int8_t> cs(params_.m());
+        for (int j = 0; j < params_.m(); j++) {
+            cs[j] = static_cast<int8_t>(c[j] * s_ternary_[j]);
+        }
+        std::vector<uint32_t> ct(params_.n());
+        ternary_matvec(native_matrix(), pack_ternary(cs.data(), params_.m()), ct.data());
+        return recompute_native(ct, z);
+    }
+    if (rns_ && to_ternary(challenge, c)) {
+        // A(z - c*s) exactly over the integers, reduced mod q once
+        std::vector<int32_t> v;
+        if (to_small_centered(z, params_.q(), A_rns_.max_coeff() - 1, v)) {
+            for (int j = 0; j < params_.m(); j++) {
+                v[j] -= c[j] * s_ternary_[j];
+            }
+            return A_rns_.multiply(v);
+        }
+    }
 
-    // Compute Az
+    // Compute Az - ct
     NTL::vec_ZZ_p Az = matrix_vector_mod(A_, z);
+    NTL::vec_ZZ_p ct = challenge_product(challenge);
+    NTL::vec_ZZ_p w;
+    w.SetLength(params_.n());
+    for (int i = 0; i < params_.n(); i++) {
+        w[i] = Az[i] - ct[i];
+    }
+    return w;
+}
+
+NTL::vec_ZZ_p LatticeProof::recompute_commitment(const SparseChallenge& challenge,
+                                                 const NTL::vec_ZZ& z) const {
+    // Coefficients of c*s on the support of c
+    const int weight = challenge.weight();
+    std::vector<int8_t> cs(weight);
+    for (int k = 0; k < weight; k++) {
+        cs[k] = static_cast<int8_t>(challenge.sign[k] * NTL::conv<long>(s_[challenge.index[k]]));
+    }
+
+    if (native_) {
+        std::vector<uint32_t> ct(params_.n());
+        sparse_matvec(native_matrix(), challenge.index.data(), cs.data(), weight, ct.data());
+        return recompute_native(ct, z);
+    }
+    if (rns_) {
+        std::vector<int32_t> v;
+        if (to_small_centered(z, params_.q(), A_rns_.max_coeff() - 1, v)) {
+            for (int k = 0; k < weight; k++) {
+                v[challenge.index[k]] -= cs[k];
+            }
+            return A_rns_.multiply(v);
+        }
+    }
+
+    NTL::vec_ZZ_p w = matrix_vector_mod(A_, z);
+    NTL::vec_ZZ_p ct = challenge_product(challenge);
+    for (int i = 0; i < params_.n(); i++) {
+        w[i] -= ct[i];
+    }
+    return w;
+}
+
+NTL::vec_ZZ_p LatticeProof::challenge_product(const NTL::vec_ZZ& challenge) const {
+    std::vector<int8_t> c;
+    if (native_ && to_ternary(challenge, c)) {
+        // The entrywise product of ternary vectors is ternary
+        std::vector<int8_t> cs(params_.m());
+        for (int j = 0; j < params_.m(); j++) {
+            cs[j] = static_cast<int8_t>(c[j] * s_ternary_[j]);
+        }
+        std::vector<uint32_t> ct(params_.n());
+        ternary_matvec(native_matrix(), pack_ternary(cs.data(), params_.m()), ct.data());
+        return from_native(ct.data(), params_.n());
+    }
 
-    // Compute ct
     NTL::vec_ZZ_p ct;
     ct.SetLength(params_.n());
     for (int i = 0; i < params_.n(); i++) {
@@ -85,19 +587,93 @@ bool LatticeProof::verify(const NTL::vec_ZZ_p& u,
             ct[i] += NTL::conv<NTL::ZZ_p>(challenge[j]) * A_[i][j] * NTL::conv<NTL::ZZ_p>(s_[j]);
         }
     }
+    return ct;
+}
+
+NTL::vec_ZZ_p LatticeProof::challenge_product(const SparseChallenge& challenge) const {
+    // Only the weight columns selected by c contribute
+    const int weight = challenge.weight();
+    std::vector<int8_t> cs(weight);
+    for (int k = 0; k < weight; k++) {
+        cs[k] = static_cast<int8_t>(challenge.sign[k] * NTL::conv<long>(s_[challenge.index[k]]));
+    }
+    if (native_) {
+        std::vector<uint32_t> ct(params_.n());
+        sparse_matvec(native_matrix(), challenge.index.data(), cs.data(), weight, ct.data());
+        return from_native(ct.data(), params_.n());
+    }
+
+    NTL::vec_ZZ_p ct;
+    ct.SetLength(params_.n());
+    for (int i = 0; i < params_.n(); i++) {
+        ct[i] = NTL::conv<NTL::ZZ_p>(0);
+        for (int k = 0; k < weight; k++) {
+            ct[i] += NTL::conv<NTL::ZZ_p>(static_cast<long>(cs[k])) * A_[i][challenge.index[k]];
+        }
+    }
+    return ct;
+}
 
-    // Compute u + ct
-    NTL::vec_ZZ_p rhs;
-    rhs.SetLength(params_.n());
+NTL::vec_ZZ_p LatticeProof::recompute_native(const std::vector<uint32_t>& ct,
+                                             const NTL::vec_ZZ& z) const {
+    // Compute Az (z has passed the norm check, so its centered form is small)
+    std::vector<int32_t> z_centered = to_centered(z, params_.q());
+    std::vector<uint32_t> w(params_.n());
+    plan_matvec(plan_, native_matrix(), z_centered.data(), 1, w.data(), panel_matrix());
+
+    // Compute Az - ct
+    const uint32_t q = A_native_.q;
     for (int i = 0; i < params_.n(); i++) {
-        rhs[i] = u[i] + ct[i];
+        w[i] = w[i] >= ct[i] ? w[i] - ct[i] : w[i] + (q - ct[i]);
+    }
+    return from_native(w.data(), params_.n());
+}
+
+MemoryFootprint LatticeProof::footprint() const {
+    MemoryFootprint f;
+    f.object = sizeof(*this);
+    f.matrix = heap_bytes(A_, params_.q());
+    f.public_key = heap_bytes(t_, params_.q());
+    f.secret = heap_bytes(s_) + heap_bytes(s_ternary_);
+    f.session = heap_bytes(y_);
+    f.kernels = heap_bytes(A_native_.data) + heap_bytes(A_panels_.data) + heap_bytes(A_replicas_) +
+                A_rns_.heap_bytes();
+    for (const NativeMatrix& replica : A_replicas_) {
+        f.kernels += heap_bytes(replica.data);
+    }
+    f.kernels += heap_bytes(A_panel_replicas_);
+    for (const PanelMatrix& replica : A_panel_replicas_) {
+        f.kernels += heap_bytes(replica.data);
+    }
+    return f;
+}
+
+const NativeMatrix& LatticeProof::native_matrix() const {
+    if (A_replicas_.empty()) {
+        return A_native_;
+    }
+    return A_replicas_[std::min<size_t>(current_numa_node(), A_replicas_.size() - 1)];
+}
+
+const PanelMatrix* LatticeProof::panel_matrix() const {
+    if (A_panel_replicas_.empty()) {
+        return &A_panels_;
     }
+    return &A_panel_replicas_[std::min<size_t>(current_numa_node(), A_panel_replicas_.size() - 1)];
+}
 
-    return Az == rhs;
+void LatticeProof::check_compression_enabled() const {
+    if (params_.commitment_drop_bits() <= 0) {
+        throw std::invalid_argument("Commitment compression is not enabled for these parameters");
+    }
 }
 
 NTL::vec_ZZ LatticeProof::generate_challenge(int length) {
     return protocol::generate_challenge(length);
 }
 
+SparseChallenge LatticeProof::generate_sparse_challenge(int length, int weight) {
+    return protocol::sample_sparse_challenge(length, weight);
+}
+
 } // namespace protocol
\ No newline at end of file
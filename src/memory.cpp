@@ -0,0 +1,122 @@
+#include "protocol/memory.hpp"
+#include <atomic>
+
+namespace protocol {
+
+namespace {
+
+const size_t kBlockOverhead = 2 * sizeof(void*);  // malloc header and rounding
+const size_t kZZHeader = 2 * sizeof(long);        // alloc and size words
+
+size_t limbs(long bits) {
+    return static_cast<size_t>((bits + 63) / 64);
+}
+
+size_t zz_block(size_t limb_count) {
+    return kBlockOverhead + kZZHeader + 8 * limb_count;
+}
+
+// NTL vectors keep a four-word header in front of the element array
+template <class Vec>
+size_t vec_block(const Vec& v) {
+    if (v.MaxLength() == 0) {
+        return 0;
+    }
+    return kBlockOverhead + 4 * sizeof(long) + v.MaxLength() * sizeof(v[0]);
+}
+
+struct PhaseCounters {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<uint64_t> bytes_allocated{0};
+    std::atomic<uint64_t> bytes_freed{0};
+};
+
+PhaseCounters counters[kAllocPhases];
+std::atomic<bool> hook_seen{false};
+thread_local AllocPhase current_phase = AllocPhase::Other;
+
+} // namespace
+
+size_t heap_bytes(const NTL::ZZ& v) {
+    return v == 0 ? 0 : zz_block(limbs(NTL::NumBits(v)));
+}
+
+size_t heap_bytes(const NTL::vec_ZZ& v) {
+    size_t bytes = vec_block(v);
+    for (long i = 0; i < v.length(); i++) {
+        bytes += heap_bytes(v[i]);
+    }
+    return bytes;
+}
+
+size_t heap_bytes(const NTL::vec_ZZ_p& v, const NTL::ZZ& q) {
+    // Every ZZ_p carries a block sized for the modulus, whatever its value
+    return vec_block(v) + v.length() * zz_block(limbs(NTL::NumBits(q)));
+}
+
+size_t heap_bytes(const NTL::mat_ZZ_p& M, const NTL::ZZ& q) {
+    size_t bytes = kBlockOverhead + 4 * sizeof(long) + M.NumRows() * sizeof(NTL::vec_ZZ_p);
+    for (long i = 0; i < M.NumRows(); i++) {
+        bytes += heap_bytes(M[i], q);
+    }
+    return bytes;
+}
+
+const char* phase_name(AllocPhase phase) {
+    switch (phase) {
+        case AllocPhase::Setup: return "setup";
+        case AllocPhase::Commit: return "commit";
+        case AllocPhase::Respond: return "respond";
+        case AllocPhase::Verify: return "verify";
+        default: return "other";
+    }
+}
+
+AllocPhaseScope::AllocPhaseScope(AllocPhase phase) : saved_(current_phase) {
+    current_phase = phase;
+}
+
+AllocPhaseScope::~AllocPhaseScope() {
+    current_phase = saved_;
+}
+
+bool alloc_hook_installed() {
+    return hook_seen.load(std::memory_order_relaxed);
+}
+
+AllocCounters alloc_counters(AllocPhase phase) {
+    const PhaseCounters& c = counters[static_cast<int>(phase)];
+    AllocCounters out;
+    out.allocations = c.allocations.load(std::memory_order_relaxed);
+    out.frees = c.frees.load(std::memory_order_relaxed);
+    out.bytes_allocated = c.bytes_allocated.load(std::memory_order_relaxed);
+    out.bytes_freed = c.bytes_freed.load(std::memory_order_relaxed);
+    return out;
+}
+
+void reset_alloc_counters() {
+    for (PhaseCounters& c : counters) {
+        c.allocations.store(0, std::memory_order_relaxed);
+        c.frees.store(0, std::memory_order_relaxed);
+        c.bytes_allocated.store(0, std::memory_order_relaxed);
+        c.bytes_freed.store(0, std::memory_order_relaxed);
+    }
+}
+
+void record_allocation(size_t bytes) {
+    PhaseCounters& c = counters[static_cast<int>(current_phase)];
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+    c.bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+    if (!hook_seen.load(std::memory_order_relaxed)) {
+        hook_seen.store(true, std::memory_order_relaxed);
+    }
+}
+
+void record_free(size_t bytes) {
+    PhaseCounters& c = counters[static_cast<int>(current_phase)];
+    c.frees.fetch_add(1, std::memory_order_relaxed);
+    c.bytes_freed.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+} // namespace protocol
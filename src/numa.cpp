@@ -0,0 +1,148 @@
+#include "protocol/numa.hpp"
+#include <algorithm>
+#include <dirent.h>
+#include <fstream>
+#include <sched.h>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace protocol {
+
+namespace {
+
+// Parses a sysfs CPU list such as "0-3,8-11"
+std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        size_t dash = range.find('-');
+        int lo = std::stoi(range.substr(0, dash));
+        int hi = dash == std::string::npos ? lo : std::stoi(range.substr(dash + 1));
+        for (int c = lo; c <= hi; c++) {
+            cpus.push_back(c);
+        }
+    }
+    return cpus;
+}
+
+NumaTopology detect_topology() {
+    NumaTopology topology;
+    const std::string root = "/sys/devices/system/node";
+    if (DIR* dir = opendir(root.c_str())) {
+        std::vector<int> ids;
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.compare(0, 4, "node") == 0 && name.size() > 4 &&
+                name.find_first_not_of("0123456789", 4) == std::string::npos) {
+                ids.push_back(std::stoi(name.substr(4)));
+            }
+        }
+        closedir(dir);
+        std::sort(ids.begin(), ids.end());
+        for (int id : ids) {
+            std::ifstream in(root + "/node" + std::to_string(id) + "/cpulist");
+            std::string list;
+            std::getline(in, list);
+            std::vector<int> cpus;
+            try {
+                cpus = parse_cpu_list(list);
+            } catch (const std::exception&) {
+                cpus.clear();
+            }
+            // Memory-only nodes have no CPUs to run workers on
+            if (!cpus.empty()) {
+                topology.node_cpus.push_back(cpus);
+            }
+        }
+    }
+    if (topology.node_cpus.empty()) {
+        std::vector<int> all;
+        for (unsigned c = 0; c < std::max(1u, std::thread::hardware_concurrency()); c++) {
+            all.push_back(static_cast<int>(c));
+        }
+        topology.node_cpus.push_back(all);
+    }
+    return topology;
+}
+
+void pin_to(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus) {
+        if (c >= 0 && c < CPU_SETSIZE) CPU_SET(c, &set);
+    }
+    // Best effort: without the affinity the replica still works, just not
+    // necessarily on the intended node
+    sched_setaffinity(0, sizeof(set), &set);
+}
+
+} // namespace
+
+int NumaTopology::node_of_cpu(int cpu) const {
+    for (int node = 0; node < nodes(); node++) {
+        for (int c : node_cpus[node]) {
+            if (c == cpu) return node;
+        }
+    }
+    return 0;
+}
+
+const NumaTopology& numa_topology() {
+    static const NumaTopology topology = detect_topology();
+    return topology;
+}
+
+int current_numa_node() {
+    const NumaTopology& topology = numa_topology();
+    if (topology.nodes() <= 1) {
+        return 0;
+    }
+    int cpu = sched_getcpu();
+    return cpu < 0 ? 0 : topology.node_of_cpu(cpu);
+}
+
+namespace {
+
+// build(node) on a thread pinned to each node of topology in turn, so the
+// pages it first touches are local to that node
+template <class T, class Build>
+std::vector<T> build_per_node(const NumaTopology& topology, Build build) {
+    std::vector<T> replicas;
+    if (topology.nodes() <= 1) {
+        return replicas;
+    }
+    replicas.resize(topology.nodes());
+    std::vector<std::thread> builders;
+    for (int node = 0; node < topology.nodes(); node++) {
+        builders.emplace_back([&, node] {
+            pin_to(topology.node_cpus[node]);
+            replicas[node] = build();
+        });
+    }
+    for (auto& t : builders) {
+        t.join();
+    }
+    return replicas;
+}
+
+} // namespace
+
+std::vector<NativeMatrix> replicate_per_node(const NativeMatrix& M, const NumaTopology& topology) {
+    return build_per_node<NativeMatrix>(topology, [&M] {
+        NativeMatrix r;
+        r.rows = M.rows;
+        r.cols = M.cols;
+        r.q = M.q;
+        r.data.assign(M.data.begin(), M.data.end());  // first touch on this node
+        return r;
+    });
+}
+
+std::vector<PanelMatrix> replicate_panels_per_node(const NativeMatrix& M, const NumaTopology& topology) {
+    return build_per_node<PanelMatrix>(topology, [&M] { return to_panels(M); });
+}
+
+} // namespace protocol
@@ -0,0 +1,98 @@
+#include "protocol/pages.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <sys/mman.h>
+
+namespace protocol {
+
+namespace {
+
+bool env_flag(const char* name) {
+    const char* v = std::getenv(name);
+    return v && std::strcmp(v, "0") != 0 && *v != '\0';
+}
+
+std::atomic<bool> huge_pages{env_flag("LATTICE_ZKP_HUGEPAGES")};
+std::atomic<bool> numa_replicas{env_flag("LATTICE_ZKP_NUMA_REPLICAS")};
+
+size_t round_up(size_t bytes) {
+    return (bytes + kLargePageBytes - 1) & ~(kLargePageBytes - 1);
+}
+
+// Anonymous mapping of len bytes (a multiple of 2 MB) aligned to 2 MB
+void* map_aligned(size_t len) {
+    const size_t padded = len + kLargePageBytes;
+    void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = (start + kLargePageBytes - 1) & ~(uintptr_t(kLargePageBytes) - 1);
+    if (aligned > start) {
+        munmap(raw, aligned - start);
+    }
+    size_t tail = start + padded - (aligned + len);
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + len), tail);
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+
+} // namespace
+
+MatrixPlacement matrix_placement() {
+    MatrixPlacement placement;
+    placement.huge_pages = huge_pages.load(std::memory_order_relaxed);
+    placement.numa_replicas = numa_replicas.load(std::memory_order_relaxed);
+    return placement;
+}
+
+void set_matrix_placement(const MatrixPlacement& placement) {
+    huge_pages.store(placement.huge_pages, std::memory_order_relaxed);
+    numa_replicas.store(placement.numa_replicas, std::memory_order_relaxed);
+}
+
+void* allocate_pages(size_t bytes) {
+    if (bytes < kLargePageBytes) {
+        return ::operator new(bytes);
+    }
+    const size_t len = round_up(bytes);
+    void* p = nullptr;
+    if (huge_pages.load(std::memory_order_relaxed)) {
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_2MB)
+        // Reserved hugetlbfs pages first; these fail fast when none are free
+        p = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+        if (p == MAP_FAILED) {
+            p = nullptr;
+        }
+#endif
+    }
+    if (!p) {
+        p = map_aligned(len);
+        if (!p) {
+            throw std::bad_alloc();
+        }
+#ifdef MADV_HUGEPAGE
+        if (huge_pages.load(std::memory_order_relaxed)) {
+            madvise(p, len, MADV_HUGEPAGE);
+        }
+#endif
+    }
+    return p;
+}
+
+void free_pages(void* p, size_t bytes) {
+    if (!p) {
+        return;
+    }
+    if (bytes < kLargePageBytes) {
+        ::operator delete(p);
+        return;
+    }
+    munmap(p, round_up(bytes));
+}
+
+} // namespace protocol
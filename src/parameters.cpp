@@ -1,4 +1,6 @@
 #include "protocol/parameters.hpp"
+#include <cmath>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 
@@ -9,6 +11,10 @@ bool is_prime(const NTL::ZZ& n) {
     if (n == 2) return true;
     if (n % 2 == 0) return false;
 
+    // Trial division is exact but hopeless for the wide moduli the RNS backend
+    // targets; use Miller-Rabin there
+    if (NTL::NumBits(n) > 40) return NTL::ProbPrime(n);
+
     NTL::ZZ sqrtn = SqrRoot(n);
     for (NTL::ZZ i = NTL::ZZ(3); i <= sqrtn; i += 2) {
         if (n % i == 0) return false;
@@ -19,10 +25,16 @@ bool is_prime(const NTL::ZZ& n) {
 Parameters::Parameters(int n, int m, const NTL::ZZ& q, 
                      int y_range, int s_range, 
                      double safety_factor,
-                     double sigma)
+                     double sigma,
+                     int challenge_weight,
+                     int commitment_drop_bits,
+                     double rejection_repetitions)
     : n_(n), m_(m), q_(q), 
       y_range_(y_range), s_range_(s_range), 
-      safety_factor_(safety_factor), sigma_(sigma) {
+      safety_factor_(safety_factor), sigma_(sigma),
+      challenge_weight_(challenge_weight),
+      commitment_drop_bits_(commitment_drop_bits),
+      rejection_repetitions_(rejection_repetitions) {
     if (!validate()) {
         throw std::invalid_argument("Invalid parameters");
     }
@@ -52,6 +64,89 @@ Parameters Parameters::HighSecurityParams() {
     );
 }
 
+NTL::ZZ Parameters::special_prime(int bits, ModulusForm form) {
+    if (bits < 3 || bits > 63) {
+        throw std::invalid_argument("Special primes are searched for between 3 and 63 bits");
+    }
+    const NTL::ZZ top = NTL::power2_ZZ(bits);
+    if (form == ModulusForm::PseudoMersenne) {
+        for (long c = 1; c < (1L << (bits / 2)); c += 2) {
+            if (is_prime(top - c)) return top - c;
+        }
+    } else if (form == ModulusForm::Solinas) {
+        for (int j = 2; j < bits; j++) {
+            NTL::ZZ q = top - NTL::power2_ZZ(j) + 1;
+            if (is_prime(q)) return q;
+        }
+    }
+    throw std::invalid_argument(std::string("No ") + modulus_form_name(form) + " prime of " +
+                                std::to_string(bits) + " bits");
+}
+
+Parameters Parameters::SpecialModulusParams(int n, int m, int bits, ModulusForm form) {
+    return Parameters(n, m, special_prime(bits, form));
+}
+
+Parameters Parameters::RejectionSamplingParams(int n, int m, const NTL::ZZ& q,
+                                               double repetitions, int challenge_weight) {
+    const int s_range = 1;
+    const int coeffs = challenge_weight > 0 ? challenge_weight : m;
+    return Parameters(
+        n, m, q,
+        rejection_y_range(coeffs, s_range, repetitions),
+        s_range,
+        10.0,   // safety_factor
+        1.5,    // sigma
+        challenge_weight,
+        0,      // commitment_drop_bits
+        repetitions
+    );
+}
+
+int Parameters::rejection_y_range(int coeffs, int s_range, double repetitions) {
+    if (coeffs <= 0 || s_range <= 0 || repetitions <= 1.0) {
+        throw std::invalid_argument("Rejection sampling needs coeffs, s_range > 0 and repetitions > 1");
+    }
+    // Each tested coordinate survives with probability (2(y-s)+1)/(2y+1), so
+    // we need coeffs * log((2y+1)/(2(y-s)+1)) <= log(repetitions)
+    const double budget = std::log(repetitions);
+    auto fits = [&](double y) {
+        return coeffs * std::log((2 * y + 1) / (2 * (y - s_range) + 1)) <= budget;
+    };
+    double hi = s_range + 1;
+    while (!fits(hi)) {
+        hi *= 2;
+        if (hi > std::numeric_limits<int>::max()) {
+            throw std::invalid_argument("Requested rejection rate needs an unrepresentable y_range");
+        }
+    }
+    long lo = s_range;  // never fits: the bound would be zero width
+    long top = static_cast<long>(hi);
+    while (top - lo > 1) {
+        long mid = lo + (top - lo) / 2;
+        if (fits(mid)) top = mid; else lo = mid;
+    }
+    return static_cast<int>(top);
+}
+
+ModulusForm Parameters::modulus_form() const {
+    if (NTL::NumBits(q_) > 63) {
+        return ModulusForm::Generic;
+    }
+    int k;
+    uint64_t c;
+    return classify_modulus(static_cast<uint64_t>(NTL::conv<long>(q_)), k, c);
+}
+
+double Parameters::expected_repetitions() const {
+    // Dense challenges are counted as fully supported, an upper bound
+    const int coeffs = challenge_weight_ > 0 ? challenge_weight_ : m_;
+    if (y_range_ <= s_range_) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return std::exp(coeffs * std::log((2.0 * y_range_ + 1) / (2.0 * (y_range_ - s_range_) + 1)));
+}
+
 bool Parameters::validate() const {
     if (n_ <= 0 || m_ <= 0) {
         throw std::invalid_argument("Dimensions must be positive");
@@ -68,22 +163,58 @@ bool Parameters::validate() const {
     if (sigma_ <= 0) {
         throw std::invalid_argument("Sigma must be positive");
     }
+    if (challenge_weight_ < 0 || challenge_weight_ > m_) {
+        throw std::invalid_argument("Challenge weight must be in [0, m]");
+    }
+    if (commitment_drop_bits_ < 0 || commitment_drop_bits_ >= NTL::NumBits(q_) ||
+        (commitment_drop_bits_ > 0 && NTL::NumBits(q_) - commitment_drop_bits_ > 64)) {
+        throw std::invalid_argument("Commitment drop bits must leave between 1 and 64 high bits");
+    }
+    if (rejection_repetitions_ < 0) {
+        throw std::invalid_argument("Rejection repetitions must be non-negative");
+    }
+    if (rejection_repetitions_ > 0 && expected_repetitions() > rejection_repetitions_) {
+        throw std::invalid_argument("y_range is too small for the requested rejection rate");
+    }
     if (!is_prime(q_)) {
         throw std::invalid_argument("Modulus must be prime");
     }
     return true;
 }
 
+bool Parameters::operator==(const Parameters& other) const {
+    return n_ == other.n_ && m_ == other.m_ && q_ == other.q_ &&
+           y_range_ == other.y_range_ && s_range_ == other.s_range_ &&
+           safety_factor_ == other.safety_factor_ && sigma_ == other.sigma_ &&
+           challenge_weight_ == other.challenge_weight_ &&
+           commitment_drop_bits_ == other.commitment_drop_bits_ &&
+           rejection_repetitions_ == other.rejection_repetitions_;
+}
+
 std::string Parameters::toString() const {
     std::stringstream ss;
     ss << "Parameters:\n"
        << "  n = " << n_ << "\n"
        << "  m = " << m_ << "\n"
-       << "  q = " << q_ << " (bits: " << NTL::NumBits(q_) << ")\n"
+       << "  q = " << q_ << " (bits: " << NTL::NumBits(q_);
+    if (modulus_form() != ModulusForm::Generic) {
+        ss << ", " << modulus_form_name(modulus_form());
+    }
+    ss << ")\n"
        << "  y_range = " << y_range_ << "\n"
        << "  s_range = " << s_range_ << "\n"
        << "  safety_factor = " << safety_factor_ << "\n"
        << "  sigma = " << sigma_ << "\n";
+    if (challenge_weight_ > 0) {
+        ss << "  challenge_weight = " << challenge_weight_ << "\n";
+    }
+    if (commitment_drop_bits_ > 0) {
+        ss << "  commitment_drop_bits = " << commitment_drop_bits_ << "\n";
+    }
+    if (rejection_repetitions_ > 0) {
+        ss << "  rejection_repetitions = " << rejection_repetitions_
+           << " (expected " << expected_repetitions() << ")\n";
+    }
     return ss.str();
 }
 
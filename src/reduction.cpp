@@ -0,0 +1,42 @@
+#include "protocol/reduction.hpp"
+#include <stdexcept>
+
+namespace protocol {
+
+const char* modulus_form_name(ModulusForm form) {
+    switch (form) {
+        case ModulusForm::PseudoMersenne: return "pseudo-Mersenne";
+        case ModulusForm::Solinas: return "Solinas";
+        default: return "generic";
+    }
+}
+
+ModulusForm classify_modulus(uint64_t q, int& k, uint64_t& c) {
+    if (q < 3 || q >> 63) {
+        return ModulusForm::Generic;
+    }
+    k = 64 - __builtin_clzll(q);
+    c = (uint64_t(1) << k) - q;
+    if (c > 1 && (c & (c + 1)) == 0) {
+        return ModulusForm::Solinas;  // c + 1 = 2^j with 1 < j < k
+    }
+    if (c < (uint64_t(1) << (k / 2))) {
+        return ModulusForm::PseudoMersenne;
+    }
+    return ModulusForm::Generic;
+}
+
+Reducer::Reducer(uint32_t q) : q_(q) {
+    if (q == 0) {
+        throw std::invalid_argument("Modulus must be positive");
+    }
+    form_ = classify_modulus(q, k_, c_);
+    if (form_ == ModulusForm::Solinas) {
+        shift_ = 64 - __builtin_clzll(c_);
+    }
+    if (form_ != ModulusForm::Generic) {
+        mask_ = (uint64_t(1) << k_) - 1;
+    }
+}
+
+} // namespace protocol
@@ -0,0 +1,391 @@
+#include "protocol/response_codec.hpp"
+#include "protocol/kernels.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LATTICE_ZKP_X86 1
+#endif
+
+namespace protocol {
+
+namespace {
+
+const int kLanes = ResponseCodec::kLanes;
+const uint32_t kStateLow = 1u << 16;  // lane states live in [2^16, 2^32)
+const int32_t kEscape = std::numeric_limits<int32_t>::min();
+
+void put_varint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+uint32_t read_word(const uint8_t* words, size_t i) {
+    return uint32_t(words[2 * i]) | uint32_t(words[2 * i + 1]) << 8;
+}
+
+#ifdef LATTICE_ZKP_X86
+// Lane i of entry mask takes the popcount(mask & ((1 << i) - 1))-th fresh word,
+// so lanes that refill read consecutive words in lane order
+const uint32_t* refill_permutations() {
+    static const std::array<uint32_t, 256 * kLanes> table = [] {
+        std::array<uint32_t, 256 * kLanes> t{};
+        for (int mask = 0; mask < 256; mask++) {
+            for (int i = 0; i < kLanes; i++) {
+                t[mask * kLanes + i] = __builtin_popcount(mask & ((1 << i) - 1));
+            }
+        }
+        return t;
+    }();
+    return table.data();
+}
+
+// Whole groups of kLanes coefficients, all lanes per step: one gather each for
+// the coefficient and the state update, and a permute that hands the next
+// words to the lanes that fell below 2^16. Stops while 8 words (the most a
+// step reads) are still available; returns the groups done.
+__attribute__((target("avx2")))
+long decode_groups_avx2(const int32_t* slot_value, const uint32_t* slot_step, int scale_bits,
+                        long groups, const uint8_t* words, size_t word_count, size_t& pos,
+                        uint32_t* x, int32_t* out) {
+    const uint32_t* permutations = refill_permutations();
+    const __m256i slot_mask = _mm256_set1_epi32((1 << scale_bits) - 1);
+    const __m256i low_mask = _mm256_set1_epi32(0xffff);
+    const __m128i scale = _mm_cvtsi32_si128(scale_bits);
+    __m256i state = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x));
+    long g = 0;
+    for (; g < groups && word_count - pos >= kLanes; g++) {
+        const __m256i slot = _mm256_and_si256(state, slot_mask);
+        const __m256i step = _mm256_i32gather_epi32(reinterpret_cast<const int*>(slot_step), slot, 4);
+        const __m256i value = _mm256_i32gather_epi32(slot_value, slot, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + g * kLanes), value);
+
+        const __m256i freq = _mm256_and_si256(step, low_mask);
+        const __m256i bias = _mm256_srli_epi32(step, 16);
+        state = _mm256_add_epi32(_mm256_mullo_epi32(freq, _mm256_srl_epi32(state, scale)), bias);
+
+        const __m256i need = _mm256_cmpeq_epi32(_mm256_srli_epi32(state, 16), _mm256_setzero_si256());
+        const int mask = _mm256_movemask_ps(_mm256_castsi256_ps(need));
+        __m256i fresh = _mm256_cvtepu16_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + 2 * pos)));
+        fresh = _mm256_permutevar8x32_epi32(
+            fresh, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(permutations + mask * kLanes)));
+        state = _mm256_blendv_epi8(state, _mm256_or_si256(_mm256_slli_epi32(state, 16), fresh), need);
+        pos += __builtin_popcount(mask);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(x), state);
+    return g;
+}
+#endif
+
+} // namespace
+
+ResponseCodec::ResponseCodec(const Parameters& params)
+    : m_(params.m()), q_(params.q()), width_(NTL::NumBytes(params.q())) {
+    const long y_range = params.y_range();
+    bound_ = y_range + params.s_range();
+    const long symbols = 2 * bound_ + 2;  // coefficients, then the escape
+    if (symbols > 4096) {
+        throw std::invalid_argument("Response codec needs y_range + s_range below 2048");
+    }
+    scale_bits_ = 12;
+    while ((1L << scale_bits_) < 16 * symbols && scale_bits_ < 16) {
+        scale_bits_++;
+    }
+
+    // z = y + c*s: y uniform on [-y_range, y_range], c*s = +-1 with the chance
+    // of c and s both being nonzero (c has weight nonzero entries if sparse)
+    const int weight = params.challenge_weight();
+    const double p_sign = weight > 0 ? weight / (3.0 * m_) : 2.0 / 9.0;
+    const double p_shift[3] = {p_sign, 1.0 - 2 * p_sign, p_sign};
+    std::vector<double> p(symbols - 1, 0.0);
+    for (long v = -bound_; v <= bound_; v++) {
+        for (int e = -1; e <= 1; e++) {
+            if (std::abs(v - e) <= y_range) {
+                p[v + bound_] += p_shift[e + 1] / (2 * y_range + 1);
+            }
+        }
+    }
+    entropy_bits_ = 0;
+    for (double pk : p) {
+        if (pk > 0) entropy_bits_ -= m_ * pk * std::log2(pk);
+    }
+
+    // Quantize to 2^scale_bits slots, one reserved for the escape; every
+    // coefficient in range keeps at least one so it stays codable
+    const long total = (1L << scale_bits_) - 1;
+    freq_.assign(symbols, 1);
+    long sum = 0;
+    for (long k = 0; k + 1 < symbols; k++) {
+        freq_[k] = static_cast<uint32_t>(std::max<long>(1, std::lround(p[k] * total)));
+        sum += freq_[k];
+    }
+    while (sum != total) {
+        auto largest = std::max_element(freq_.begin(), freq_.end() - 1);
+        if (sum > total) {
+            (*largest)--;
+            sum--;
+        } else {
+            (*largest)++;
+            sum++;
+        }
+    }
+
+    start_.resize(symbols);
+    slot_value_.resize(1L << scale_bits_);
+    slot_step_.resize(1L << scale_bits_);
+    uint32_t start = 0;
+    for (long k = 0; k < symbols; k++) {
+        start_[k] = start;
+        for (uint32_t slot = start; slot < start + freq_[k]; slot++) {
+            slot_value_[slot] = k + 1 < symbols ? static_cast<int32_t>(k - bound_) : kEscape;
+            slot_step_[slot] = freq_[k] | (slot - start) << 16;
+        }
+        start += freq_[k];
+    }
+}
+
+std::vector<uint8_t> ResponseCodec::encode(const NTL::vec_ZZ& z) const {
+    if (z.length() != m_) {
+        throw std::invalid_argument("Response vector has wrong dimension");
+    }
+    const long escape = 2 * bound_ + 1;
+    const NTL::ZZ half = q_ / 2;
+    std::vector<uint16_t> symbols(m_);
+    std::vector<uint8_t> escapes;
+    size_t escape_count = 0;
+    for (long j = 0; j < m_; j++) {
+        NTL::ZZ r = z[j] % q_;
+        NTL::ZZ c = r > half ? r - q_ : r;
+        if (NTL::abs(c) <= bound_) {
+            symbols[j] = static_cast<uint16_t>(NTL::conv<long>(c) + bound_);
+        } else {
+            symbols[j] = static_cast<uint16_t>(escape);
+            escapes.resize(escapes.size() + width_);
+            NTL::BytesFromZZ(escapes.data() + escapes.size() - width_, r, width_);
+            escape_count++;
+        }
+    }
+    return finish(symbols, escapes, escape_count);
+}
+
+std::vector<uint8_t> ResponseCodec::encode(Span<const int32_t> z) const {
+    check_native();
+    if (static_cast<long>(z.size()) != m_) {
+        throw std::invalid_argument("Response vector has wrong dimension");
+    }
+    const int64_t q = NTL::conv<long>(q_);
+    const long escape = 2 * bound_ + 1;
+    std::vector<uint16_t> symbols(m_);
+    std::vector<uint8_t> escapes;
+    size_t escape_count = 0;
+    for (long j = 0; j < m_; j++) {
+        int64_t r = z[j] % q;
+        if (r < 0) r += q;
+        const int64_t c = r > q / 2 ? r - q : r;
+        if (std::llabs(c) <= bound_) {
+            symbols[j] = static_cast<uint16_t>(c + bound_);
+        } else {
+            symbols[j] = static_cast<uint16_t>(escape);
+            for (long b = 0; b < width_; b++) {
+                escapes.push_back(static_cast<uint8_t>(r >> (8 * b)));
+            }
+            escape_count++;
+        }
+    }
+    return finish(symbols, escapes, escape_count);
+}
+
+std::vector<uint8_t> ResponseCodec::finish(const std::vector<uint16_t>& symbols,
+                                           const std::vector<uint8_t>& escapes,
+                                           size_t escape_count) const {
+    // rANS codes last to first; words are collected back to front and
+    // reversed so the decoder reads forward, lane 0 first within a step
+    std::vector<uint16_t> words;
+    words.reserve(symbols.size() + 2 * kLanes);
+    uint32_t x[kLanes];
+    std::fill(x, x + kLanes, kStateLow);
+    const long groups = (m_ + kLanes - 1) / kLanes;
+    for (long g = groups - 1; g >= 0; g--) {
+        for (int lane = kLanes - 1; lane >= 0; lane--) {
+            const long j = g * kLanes + lane;
+            if (j >= m_) continue;
+            const uint32_t f = freq_[symbols[j]];
+            const uint64_t x_max = static_cast<uint64_t>((kStateLow >> scale_bits_) << 16) * f;
+            if (x[lane] >= x_max) {
+                words.push_back(static_cast<uint16_t>(x[lane]));
+                x[lane] >>= 16;
+            }
+            x[lane] = ((x[lane] / f) << scale_bits_) + x[lane] % f + start_[symbols[j]];
+        }
+    }
+    for (int lane = kLanes - 1; lane >= 0; lane--) {
+        words.push_back(static_cast<uint16_t>(x[lane] >> 16));
+        words.push_back(static_cast<uint16_t>(x[lane]));
+    }
+    std::reverse(words.begin(), words.end());
+
+    std::vector<uint8_t> out;
+    out.reserve(10 + escapes.size() + 2 * words.size());
+    put_varint(out, escape_count);
+    out.insert(out.end(), escapes.begin(), escapes.end());
+    for (uint16_t w : words) {
+        out.push_back(static_cast<uint8_t>(w));
+        out.push_back(static_cast<uint8_t>(w >> 8));
+    }
+    return out;
+}
+
+ResponseCodec::Layout ResponseCodec::parse(const uint8_t* data, size_t size) const {
+    Layout layout;
+    uint64_t count = 0;
+    size_t pos = 0;
+    for (int shift = 0;; shift += 7) {
+        if (pos == size || shift > 63) {
+            throw std::runtime_error("Truncated response stream");
+        }
+        const uint8_t byte = data[pos++];
+        count |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) break;
+    }
+    if (count > static_cast<uint64_t>(m_) || count * width_ > size - pos) {
+        throw std::runtime_error("Truncated response stream");
+    }
+    layout.escapes = count;
+    layout.escape_data = data + pos;
+    pos += count * width_;
+    if ((size - pos) % 2 != 0 || size - pos < 4 * kLanes) {
+        throw std::runtime_error("Truncated response stream");
+    }
+    layout.words = data + pos;
+    layout.word_count = (size - pos) / 2;
+    return layout;
+}
+
+void ResponseCodec::decode_values(const Layout& layout, int32_t* out, bool vectorized) const {
+    const uint8_t* words = layout.words;
+    uint32_t x[kLanes];
+    for (int lane = 0; lane < kLanes; lane++) {
+        x[lane] = read_word(words, 2 * lane) | read_word(words, 2 * lane + 1) << 16;
+    }
+    size_t pos = 2 * kLanes;
+
+    const uint32_t slot_mask = (1u << scale_bits_) - 1;
+    const long groups = (m_ + kLanes - 1) / kLanes;
+    long g = 0;
+#ifdef LATTICE_ZKP_X86
+    if (vectorized && avx2_available()) {
+        g = decode_groups_avx2(slot_value_.data(), slot_step_.data(), scale_bits_, m_ / kLanes,
+                               words, layout.word_count, pos, x, out);
+    }
+#else
+    (void)vectorized;
+#endif
+    for (; g < groups; g++) {
+        const int lanes = static_cast<int>(std::min<long>(kLanes, m_ - g * kLanes));
+        for (int lane = 0; lane < lanes; lane++) {
+            const uint32_t slot = x[lane] & slot_mask;
+            const uint32_t step = slot_step_[slot];
+            out[g * kLanes + lane] = slot_value_[slot];
+            x[lane] = (step & 0xffff) * (x[lane] >> scale_bits_) + (step >> 16);
+        }
+        for (int lane = 0; lane < lanes; lane++) {
+            if (x[lane] < kStateLow) {
+                if (pos == layout.word_count) {
+                    throw std::runtime_error("Truncated response stream");
+                }
+                x[lane] = x[lane] << 16 | read_word(words, pos++);
+            }
+        }
+    }
+
+    // A well-formed stream leaves every lane where the encoder started it
+    if (pos != layout.word_count ||
+        std::any_of(x, x + kLanes, [](uint32_t s) { return s != kStateLow; })) {
+        throw std::runtime_error("Corrupt response stream");
+    }
+}
+
+NTL::vec_ZZ ResponseCodec::decode(const uint8_t* data, size_t size) const {
+    Layout layout = parse(data, size);
+    std::vector<int32_t> values(m_);
+    decode_values(layout, values.data(), true);
+
+    const NTL::ZZ half = q_ / 2;
+    NTL::vec_ZZ z;
+    z.SetLength(m_);
+    size_t escaped = 0;
+    for (long j = 0; j < m_; j++) {
+        if (values[j] != kEscape) {
+            z[j] = values[j];
+            continue;
+        }
+        if (escaped == layout.escapes) {
+            throw std::runtime_error("Corrupt response stream");
+        }
+        NTL::ZZ r = NTL::ZZFromBytes(layout.escape_data + escaped++ * width_, width_);
+        if (r >= q_) {
+            throw std::runtime_error("Escaped coefficient out of range");
+        }
+        z[j] = r > half ? r - q_ : r;
+    }
+    if (escaped != layout.escapes) {
+        throw std::runtime_error("Corrupt response stream");
+    }
+    return z;
+}
+
+void ResponseCodec::decode(const uint8_t* data, size_t size, Span<int32_t> z) const {
+    decode_words(data, size, z, true);
+}
+
+void ResponseCodec::decode_scalar(const uint8_t* data, size_t size, Span<int32_t> z) const {
+    decode_words(data, size, z, false);
+}
+
+void ResponseCodec::decode_words(const uint8_t* data, size_t size, Span<int32_t> z,
+                                 bool vectorized) const {
+    check_native();
+    if (static_cast<long>(z.size()) != m_) {
+        throw std::invalid_argument("Response vector has wrong dimension");
+    }
+    Layout layout = parse(data, size);
+    decode_values(layout, z.data(), vectorized);
+
+    const uint32_t q = static_cast<uint32_t>(NTL::conv<long>(q_));
+    size_t escaped = 0;
+    for (int32_t& zj : z) {
+        if (zj != kEscape) continue;
+        if (escaped == layout.escapes) {
+            throw std::runtime_error("Corrupt response stream");
+        }
+        const uint8_t* p = layout.escape_data + escaped++ * width_;
+        uint32_t r = 0;
+        for (long b = width_ - 1; b >= 0; b--) {
+            r = r << 8 | p[b];
+        }
+        if (r >= q) {
+            throw std::runtime_error("Escaped coefficient out of range");
+        }
+        zj = r > q / 2 ? static_cast<int32_t>(static_cast<int64_t>(r) - q) : static_cast<int32_t>(r);
+    }
+    if (escaped != layout.escapes) {
+        throw std::runtime_error("Corrupt response stream");
+    }
+}
+
+void ResponseCodec::check_native() const {
+    if (NTL::NumBits(q_) > 32) {
+        throw std::invalid_argument("Word-sized responses need a modulus below 2^32");
+    }
+}
+
+} // namespace protocol
@@ -0,0 +1,402 @@
+#include "protocol/ring.hpp"
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sched.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LATTICE_ZKP_X86 1
+#endif
+
+namespace protocol {
+
+// Producer and consumer fields sit on separate cache lines so the two sides
+// only share a line when one reads the other's position
+struct ShmRing::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+    std::atomic<uint32_t> closed;
+
+    alignas(64) std::atomic<uint64_t> head;           // end of published messages
+    std::atomic<uint32_t> head_seq;                   // futex word, bumped per publish
+    std::atomic<uint32_t> consumer_waiting;
+
+    alignas(64) std::atomic<uint64_t> tail;           // end of released messages
+    std::atomic<uint32_t> tail_seq;                   // futex word, bumped per release
+    std::atomic<uint32_t> producer_waiting;
+};
+
+namespace {
+
+const uint32_t kRingMagic = 0x474e5252;  // "RRNG"
+const uint32_t kRingVersion = 1;
+const uint32_t kWrapMarker = 0;
+const size_t kRecordHeader = 8;          // u32 size + u32 type
+const int kSpinIterations = 1024;
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "Ring positions must be lock-free to be shared between processes");
+
+size_t record_bytes(size_t len) {
+    return (kRecordHeader + len + 7) & ~size_t(7);
+}
+
+// Header region in front of the ring data, a whole number of cache lines
+const size_t kHeaderBytes = 256;
+
+inline void cpu_relax() {
+#ifdef LATTICE_ZKP_X86
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Spinning only pays when the peer can run at the same time
+int spin_iterations() {
+    static const int spins = [] {
+        cpu_set_t set;
+        return sched_getaffinity(0, sizeof(set), &set) == 0 && CPU_COUNT(&set) > 1 ? kSpinIterations : 0;
+    }();
+    return spins;
+}
+
+// Shared (not private) futex operations, since the word lives in a mapping
+// that several processes see
+void futex_wait(std::atomic<uint32_t>& word, uint32_t expected) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, nullptr, nullptr, 0);
+}
+
+void futex_wake(std::atomic<uint32_t>& word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+// Spin on ready(), then sleep on seq with waiting raised. The waiting flag is
+// set before the final check, and the other side bumps seq before reading the
+// flag, so a wake-up cannot slip between the check and the sleep.
+template <class Ready>
+void wait_until(Ready ready, std::atomic<uint32_t>& seq, std::atomic<uint32_t>& waiting,
+                std::atomic<uint32_t>& closed) {
+    const int spins = spin_iterations();
+    for (int spin = 0; spin < spins; spin++) {
+        if (ready() || closed.load(std::memory_order_acquire)) return;
+        cpu_relax();
+    }
+    while (!ready() && !closed.load(std::memory_order_acquire)) {
+        waiting.store(1);
+        uint32_t expected = seq.load();
+        if (!ready() && !closed.load()) {
+            futex_wait(seq, expected);
+        }
+        waiting.store(0);
+    }
+}
+
+void notify(std::atomic<uint32_t>& seq, std::atomic<uint32_t>& waiting) {
+    seq.fetch_add(1);
+    if (waiting.load()) {
+        futex_wake(seq);
+    }
+}
+
+} // namespace
+
+ShmRing::ShmRing(const std::string& name, size_t capacity)
+    : name_(name), owner_(true), header_(nullptr), data_(nullptr), capacity_(capacity),
+      mapped_(0), write_end_(0), read_pos_(0) {
+    static_assert(sizeof(Header) <= kHeaderBytes, "Ring header outgrew its reserved space");
+    if (capacity < 4096 || (capacity & (capacity - 1)) != 0) {
+        throw std::invalid_argument("Ring capacity must be a power of two of at least 4 KB");
+    }
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot create shared memory ring " + name + ": " + std::strerror(errno));
+    }
+    const size_t bytes = kHeaderBytes + capacity;
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        ::close(fd);
+        shm_unlink(name.c_str());
+        throw std::runtime_error("Cannot size shared memory ring " + name);
+    }
+    try {
+        map(fd, bytes);
+    } catch (...) {
+        shm_unlink(name.c_str());
+        throw;
+    }
+
+    // The mapping starts zeroed; the magic is written last so attaching
+    // processes never see a half-initialized header
+    header_->version = kRingVersion;
+    header_->capacity = capacity;
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic = kRingMagic;
+}
+
+ShmRing::ShmRing(const std::string& name)
+    : name_(name), owner_(false), header_(nullptr), data_(nullptr), capacity_(0),
+      mapped_(0), write_end_(0), read_pos_(0) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open shared memory ring " + name + ": " + std::strerror(errno));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) <= kHeaderBytes) {
+        ::close(fd);
+        throw std::runtime_error("Not a lattice_zkp ring: " + name);
+    }
+    map(fd, static_cast<size_t>(st.st_size));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header_->magic != kRingMagic || header_->version != kRingVersion ||
+        header_->capacity != mapped_ - kHeaderBytes) {
+        munmap(header_, mapped_);
+        throw std::runtime_error("Not a lattice_zkp ring: " + name);
+    }
+    capacity_ = header_->capacity;
+    write_end_ = header_->head.load(std::memory_order_acquire);
+    read_pos_ = header_->tail.load(std::memory_order_acquire);
+}
+
+ShmRing::~ShmRing() {
+    if (header_) {
+        munmap(header_, mapped_);
+    }
+    if (owner_) {
+        shm_unlink(name_.c_str());
+    }
+}
+
+void ShmRing::map(int fd, size_t bytes) {
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        throw std::runtime_error("Cannot map shared memory ring " + name_);
+    }
+    header_ = static_cast<Header*>(p);
+    data_ = static_cast<uint8_t*>(p) + kHeaderBytes;
+    mapped_ = bytes;
+}
+
+uint8_t* ShmRing::begin_write(uint32_t type, size_t len) {
+    if (type == kWrapMarker) {
+        throw std::invalid_argument("Ring message type 0 is reserved");
+    }
+    const size_t need = record_bytes(len);
+    if (need > capacity_ / 2) {
+        throw std::invalid_argument("Message larger than half the ring");
+    }
+
+    // A message never straddles the end of the ring; the remainder is skipped
+    // with a marker (records are 8-byte aligned, so a header always fits)
+    uint64_t pos = write_end_;
+    const size_t offset = pos & (capacity_ - 1);
+    const size_t skip = capacity_ - offset < need ? capacity_ - offset : 0;
+    Header& h = *header_;
+    wait_until([&] { return pos + skip + need - h.tail.load(std::memory_order_acquire) <= capacity_; },
+               h.tail_seq, h.producer_waiting, h.closed);
+    if (h.closed.load(std::memory_order_acquire)) {
+        throw std::runtime_error("Ring closed");
+    }
+    if (skip) {
+        uint32_t marker[2] = {0, kWrapMarker};
+        std::memcpy(data_ + offset, marker, sizeof(marker));
+        pos += skip;
+    }
+    uint32_t record[2] = {static_cast<uint32_t>(len), type};
+    std::memcpy(data_ + (pos & (capacity_ - 1)), record, sizeof(record));
+    write_end_ = pos + need;
+    return data_ + (pos & (capacity_ - 1)) + kRecordHeader;
+}
+
+void ShmRing::end_write() {
+    Header& h = *header_;
+    h.head.store(write_end_, std::memory_order_release);
+    notify(h.head_seq, h.consumer_waiting);
+}
+
+bool ShmRing::next(RingRecord& record) {
+    // The peer can write anything into the mapping, so every size read from
+    // it is checked against what was published before it is followed
+    uint64_t pos = read_pos_;
+    const uint64_t head = header_->head.load(std::memory_order_acquire);
+    if (head - pos > capacity_) {
+        throw std::runtime_error("Corrupt ring: head out of range");
+    }
+    while (pos != head) {
+        const size_t offset = pos & (capacity_ - 1);
+        if (head - pos < kRecordHeader) {
+            throw std::runtime_error("Corrupt ring: truncated record header");
+        }
+        uint32_t fields[2];
+        std::memcpy(fields, data_ + offset, sizeof(fields));
+        if (fields[1] == kWrapMarker) {
+            if (capacity_ - offset > head - pos) {
+                throw std::runtime_error("Corrupt ring: wrap marker past published data");
+            }
+            pos += capacity_ - offset;
+            continue;
+        }
+        const size_t bytes = record_bytes(fields[0]);
+        if (bytes > head - pos || bytes > capacity_ - offset) {
+            throw std::runtime_error("Corrupt ring: record size out of range");
+        }
+        record.type = fields[1];
+        record.size = fields[0];
+        record.data = data_ + offset + kRecordHeader;
+        read_pos_ = pos + bytes;
+        return true;
+    }
+    return false;
+}
+
+bool ShmRing::try_read(RingRecord& record) {
+    return next(record);
+}
+
+bool ShmRing::read(RingRecord& record) {
+    Header& h = *header_;
+    wait_until([&] { return h.head.load(std::memory_order_acquire) != read_pos_; },
+               h.head_seq, h.consumer_waiting, h.closed);
+    // Messages published before close are still delivered
+    return next(record);
+}
+
+void ShmRing::release() {
+    Header& h = *header_;
+    h.tail.store(read_pos_, std::memory_order_release);
+    notify(h.tail_seq, h.producer_waiting);
+}
+
+void ShmRing::close() {
+    Header& h = *header_;
+    h.closed.store(1, std::memory_order_release);
+    notify(h.head_seq, h.consumer_waiting);
+    notify(h.tail_seq, h.producer_waiting);
+}
+
+namespace {
+
+void put_residue(uint8_t* out, const NTL::ZZ& v, long width) {
+    NTL::BytesFromZZ(out, v, width);
+}
+
+// width is the size of one element; records that are not whole elements are
+// malformed
+bool receive(ShmRing& ring, RingMessage type, RingRecord& record, size_t width = 1) {
+    if (!ring.read(record)) {
+        return false;
+    }
+    if (record.type != static_cast<uint32_t>(type)) {
+        ring.release();
+        throw std::runtime_error("Unexpected ring message type");
+    }
+    if (record.size % width != 0) {
+        ring.release();
+        throw std::runtime_error("Ring message is not a whole number of coefficients");
+    }
+    return true;
+}
+
+} // namespace
+
+void send_commitment(ShmRing& ring, const NTL::vec_ZZ_p& u) {
+    const long width = NTL::NumBytes(NTL::ZZ_p::modulus());
+    uint8_t* out = ring.begin_write(static_cast<uint32_t>(RingMessage::Commitment), u.length() * width);
+    for (long i = 0; i < u.length(); i++) {
+        put_residue(out + i * width, rep(u[i]), width);
+    }
+    ring.end_write();
+}
+
+void send_challenge(ShmRing& ring, const NTL::vec_ZZ& c) {
+    uint8_t* out = ring.begin_write(static_cast<uint32_t>(RingMessage::Challenge), c.length());
+    for (long j = 0; j < c.length(); j++) {
+        out[j] = static_cast<uint8_t>(static_cast<int8_t>(NTL::conv<long>(c[j])));
+    }
+    ring.end_write();
+}
+
+void send_response(ShmRing& ring, const NTL::vec_ZZ& z) {
+    const NTL::ZZ& q = NTL::ZZ_p::modulus();
+    const long width = NTL::NumBytes(q);
+    uint8_t* out = ring.begin_write(static_cast<uint32_t>(RingMessage::Response), z.length() * width);
+    for (long j = 0; j < z.length(); j++) {
+        put_residue(out + j * width, z[j] % q, width);
+    }
+    ring.end_write();
+}
+
+void send_verdict(ShmRing& ring, bool accepted) {
+    uint8_t* out = ring.begin_write(static_cast<uint32_t>(RingMessage::Verdict), 1);
+    out[0] = accepted ? 1 : 0;
+    ring.end_write();
+}
+
+bool receive_commitment(ShmRing& ring, NTL::vec_ZZ_p& u) {
+    RingRecord record;
+    const long width = NTL::NumBytes(NTL::ZZ_p::modulus());
+    if (!receive(ring, RingMessage::Commitment, record, width)) {
+        return false;
+    }
+    u.SetLength(static_cast<long>(record.size) / width);
+    for (long i = 0; i < u.length(); i++) {
+        u[i] = NTL::conv<NTL::ZZ_p>(NTL::ZZFromBytes(record.data + i * width, width));
+    }
+    ring.release();
+    return true;
+}
+
+bool receive_challenge(ShmRing& ring, NTL::vec_ZZ& c) {
+    RingRecord record;
+    if (!receive(ring, RingMessage::Challenge, record)) {
+        return false;
+    }
+    c.SetLength(static_cast<long>(record.size));
+    for (long j = 0; j < c.length(); j++) {
+        c[j] = static_cast<long>(static_cast<int8_t>(record.data[j]));
+    }
+    ring.release();
+    return true;
+}
+
+bool receive_response(ShmRing& ring, NTL::vec_ZZ& z) {
+    RingRecord record;
+    const NTL::ZZ& q = NTL::ZZ_p::modulus();
+    const long width = NTL::NumBytes(q);
+    if (!receive(ring, RingMessage::Response, record, width)) {
+        return false;
+    }
+    const NTL::ZZ half = q / 2;
+    z.SetLength(static_cast<long>(record.size) / width);
+    for (long j = 0; j < z.length(); j++) {
+        z[j] = NTL::ZZFromBytes(record.data + j * width, width);
+        if (z[j] > half) {
+            z[j] -= q;
+        }
+    }
+    ring.release();
+    return true;
+}
+
+bool receive_verdict(ShmRing& ring, bool& accepted) {
+    RingRecord record;
+    if (!receive(ring, RingMessage::Verdict, record)) {
+        return false;
+    }
+    accepted = record.size == 1 && record.data[0] == 1;
+    ring.release();
+    return true;
+}
+
+} // namespace protocol
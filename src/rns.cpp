@@ -0,0 +1,139 @@
+#include "protocol/rns.hpp"
+#include "protocol/memory.hpp"
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+
+namespace protocol {
+
+namespace {
+
+const long kNttOrder = 20;   // every prime has 2^20 | p - 1
+const long kPrimeBits = 31;
+
+// Channels are only worth a thread each above this many multiply-adds
+const long kParallelWork = 1L << 18;
+
+} // namespace
+
+RnsBasis::RnsBasis(const NTL::ZZ& bound) {
+    product_ = 1;
+    long k = (1L << (kPrimeBits - kNttOrder)) - 1;
+    while (product_ <= 2 * bound) {
+        for (; k > 0; k--) {
+            long p = (k << kNttOrder) + 1;
+            if (NTL::ProbPrime(p)) break;
+        }
+        if (k == 0) {
+            throw std::invalid_argument("Bound too large for the RNS prime family");
+        }
+        primes_.push_back(static_cast<uint32_t>((k << kNttOrder) + 1));
+        product_ *= NTL::ZZ(static_cast<long>(primes_.back()));
+        k--;
+    }
+
+    for (uint32_t p : primes_) {
+        NTL::ZZ P(static_cast<long>(p));
+        NTL::ZZ cofactor = product_ / P;
+        cofactors_.push_back(cofactor);
+        inverses_.push_back(static_cast<uint32_t>(NTL::conv<long>(NTL::InvMod(cofactor % P, P))));
+    }
+}
+
+NTL::ZZ RnsBasis::reconstruct(const uint32_t* residues) const {
+    NTL::ZZ x(0);
+    for (size_t k = 0; k < primes_.size(); k++) {
+        uint64_t t = static_cast<uint64_t>(residues[k]) * inverses_[k] % primes_[k];
+        x += cofactors_[k] * static_cast<long>(t);
+    }
+    x %= product_;
+    if (2 * x > product_) x -= product_;
+    return x;
+}
+
+size_t RnsBasis::heap_bytes() const {
+    size_t bytes = protocol::heap_bytes(primes_) + protocol::heap_bytes(inverses_) +
+                   protocol::heap_bytes(cofactors_) + protocol::heap_bytes(product_);
+    for (const NTL::ZZ& c : cofactors_) {
+        bytes += protocol::heap_bytes(c);
+    }
+    return bytes;
+}
+
+RnsMatrix::RnsMatrix(const NTL::mat_ZZ_p& M, long max_coeff)
+    : rows_(M.NumRows()), cols_(M.NumCols()), max_coeff_(max_coeff),
+      basis_(NTL::ZZ(std::max(cols_, 1L)) * (NTL::ZZ_p::modulus() - 1) * NTL::ZZ(max_coeff)) {
+    if (max_coeff <= 0 || max_coeff >= (1L << 31)) {
+        throw std::invalid_argument("RNS coefficient bound must be in [1, 2^31)");
+    }
+
+    channels_.resize(basis_.size());
+    for (size_t k = 0; k < basis_.size(); k++) {
+        NativeMatrix& channel = channels_[k];
+        channel.rows = rows_;
+        channel.cols = cols_;
+        channel.q = basis_.prime(k);
+        channel.data.resize(rows_ * cols_);
+        const long p = channel.q;
+        for (long i = 0; i < rows_; i++) {
+            for (long j = 0; j < cols_; j++) {
+                channel.data[i * cols_ + j] = static_cast<uint32_t>(rep(M[i][j]) % p);
+            }
+        }
+    }
+}
+
+size_t RnsMatrix::heap_bytes() const {
+    size_t bytes = basis_.heap_bytes() + protocol::heap_bytes(channels_);
+    for (const NativeMatrix& channel : channels_) {
+        bytes += protocol::heap_bytes(channel.data);
+    }
+    return bytes;
+}
+
+NTL::vec_ZZ_p RnsMatrix::multiply(const std::vector<int32_t>& v) const {
+    if (static_cast<long>(v.size()) != cols_) {
+        throw std::invalid_argument("Vector has wrong dimension");
+    }
+    for (int32_t x : v) {
+        if (std::labs(x) > max_coeff_) {
+            throw std::invalid_argument("Vector entry exceeds the RNS coefficient bound");
+        }
+    }
+
+    // Residues are stored row-major across channels for reconstruction
+    const size_t K = channels_.size();
+    std::vector<uint32_t> residues(rows_ * K);
+    auto run_channel = [&](size_t k) {
+        std::vector<uint32_t> out(rows_);
+        small_matvec(channels_[k], v.data(), out.data());
+        for (long i = 0; i < rows_; i++) {
+            residues[i * K + k] = out[i];
+        }
+    };
+
+    // A caller that is already parallel gets its channels serially
+    if (K > 1 && rows_ * cols_ >= kParallelWork && !in_serial_kernel_scope()) {
+        std::vector<std::thread> pool;
+        for (size_t k = 1; k < K; k++) {
+            pool.emplace_back(run_channel, k);
+        }
+        run_channel(0);
+        for (std::thread& t : pool) {
+            t.join();
+        }
+    } else {
+        for (size_t k = 0; k < K; k++) {
+            run_channel(k);
+        }
+    }
+
+    NTL::vec_ZZ_p result;
+    result.SetLength(rows_);
+    for (long i = 0; i < rows_; i++) {
+        result[i] = NTL::conv<NTL::ZZ_p>(basis_.reconstruct(&residues[i * K]));
+    }
+    return result;
+}
+
+} // namespace protocol
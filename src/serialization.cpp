@@ -0,0 +1,94 @@
+#include "protocol/serialization.hpp"
+#include <fstream>
+#include <iterator>
+
+namespace protocol {
+
+namespace {
+
+const uint32_t kParametersVersion = 2;  // 2 added rejection_repetitions
+const uint32_t kKeyVersion = 1;
+
+} // namespace
+
+void write_zz(ByteWriter& out, const NTL::ZZ& v) {
+    if (v < 0) {
+        throw std::invalid_argument("Cannot serialize a negative integer");
+    }
+    std::vector<uint8_t> bytes(NTL::NumBytes(v));
+    NTL::BytesFromZZ(bytes.data(), v, bytes.size());
+    out.put_u32(static_cast<uint32_t>(bytes.size()));
+    out.put_bytes(bytes.data(), bytes.size());
+}
+
+NTL::ZZ read_zz(ByteReader& in) {
+    uint32_t len = in.get_u32();
+    return NTL::ZZFromBytes(in.get_bytes(len), len);
+}
+
+void write_parameters(ByteWriter& out, const Parameters& params) {
+    out.put_tag("LZKP");
+    out.put_u32(kParametersVersion);
+    out.put_u32(params.n());
+    out.put_u32(params.m());
+    write_zz(out, params.q());
+    out.put_u32(params.y_range());
+    out.put_u32(params.s_range());
+    out.put_f64(params.safety_factor());
+    out.put_f64(params.sigma());
+    out.put_u32(params.challenge_weight());
+    out.put_u32(params.commitment_drop_bits());
+    out.put_f64(params.rejection_repetitions());
+}
+
+Parameters read_parameters(ByteReader& in) {
+    in.expect_tag("LZKP");
+    uint32_t version = in.get_u32();
+    if (version < 1 || version > kParametersVersion) {
+        throw std::runtime_error("Unsupported parameter block version");
+    }
+    int n = static_cast<int>(in.get_u32());
+    int m = static_cast<int>(in.get_u32());
+    NTL::ZZ q = read_zz(in);
+    int y_range = static_cast<int>(in.get_u32());
+    int s_range = static_cast<int>(in.get_u32());
+    double safety_factor = in.get_f64();
+    double sigma = in.get_f64();
+    int challenge_weight = static_cast<int>(in.get_u32());
+    int commitment_drop_bits = static_cast<int>(in.get_u32());
+    double rejection_repetitions = version >= 2 ? in.get_f64() : 0.0;
+    return Parameters(n, m, q, y_range, s_range, safety_factor, sigma,
+                      challenge_weight, commitment_drop_bits, rejection_repetitions);
+}
+
+void write_key_header(ByteWriter& out, const Parameters& params) {
+    out.put_tag("LZKK");
+    out.put_u32(kKeyVersion);
+    write_parameters(out, params);
+}
+
+Parameters read_key_parameters(ByteReader& in) {
+    in.expect_tag("LZKK");
+    if (in.get_u32() != kKeyVersion) {
+        throw std::runtime_error("Unsupported key file version");
+    }
+    return read_parameters(in);
+}
+
+std::vector<uint8_t> read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), {});
+}
+
+void write_file(const std::string& path, const std::vector<uint8_t>& bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    if (!file) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+}
+
+} // namespace protocol
@@ -0,0 +1,175 @@
+#include "protocol/streaming.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace protocol {
+
+namespace {
+
+// Columns multiplied in per step: enough to amortize the pass over A's rows,
+// few enough that the work keeps pace with typical network chunks
+const size_t kStreamBlock = 256;
+
+} // namespace
+
+StreamingVerifier::StreamingVerifier(const LatticeProof& proof)
+    : proof_(proof) {
+    pending_.reserve(kStreamBlock);
+}
+
+void StreamingVerifier::start(const NTL::vec_ZZ_p& u, long norm_bound) {
+    const Parameters& params = proof_.parameters();
+    if (u.length() != params.n()) {
+        throw std::invalid_argument("Commitment vector has wrong dimension");
+    }
+    u_ = u;
+    norm_bound_ = norm_bound;
+    norm_ = 0;
+    consumed_ = 0;
+    flushed_ = 0;
+    pending_.clear();
+    partial_.clear();
+    if (proof_.native_) {
+        acc_native_.assign(params.n(), 0);
+    } else {
+        acc_.SetLength(params.n());
+        for (long i = 0; i < params.n(); i++) {
+            acc_[i] = NTL::conv<NTL::ZZ_p>(0);
+        }
+    }
+    active_ = true;
+    rejected_ = false;
+}
+
+void StreamingVerifier::begin(const NTL::vec_ZZ_p& u, const NTL::vec_ZZ& challenge) {
+    AllocPhaseScope phase(AllocPhase::Verify);
+    const Parameters& params = proof_.parameters();
+    if (challenge.length() != params.m()) {
+        throw std::invalid_argument("Challenge vector has wrong dimension");
+    }
+    start(u, calculate_norm_bound(params.m(), params.y_range(), params.s_range(), params.safety_factor()));
+    ct_ = proof_.challenge_product(challenge);
+}
+
+void StreamingVerifier::begin(const NTL::vec_ZZ_p& u, const SparseChallenge& challenge) {
+    AllocPhaseScope phase(AllocPhase::Verify);
+    const Parameters& params = proof_.parameters();
+    validate_challenge(challenge, params.m(), params.challenge_weight());
+    start(u, calculate_sparse_norm_bound(params.m(), challenge.weight(), params.y_range(),
+                                         params.s_range(), params.safety_factor()));
+    ct_ = proof_.challenge_product(challenge);
+}
+
+bool StreamingVerifier::push(const NTL::ZZ& coefficient) {
+    const NTL::ZZ& q = proof_.parameters().q();
+    if (consumed_ == proof_.parameters().m()) {
+        throw std::invalid_argument("Response vector has wrong dimension");
+    }
+    consumed_++;
+
+    // Centered exactly as compute_norm_squared does (one subtraction, no
+    // reduction), so z_j - q counts with its full size; a coefficient too wide
+    // for 31 bits squares past any bound the protocol can use
+    NTL::ZZ c = coefficient;
+    if (c > q / 2) {
+        c -= q;
+    }
+    if (NTL::NumBits(c) > 31) {
+        rejected_ = true;
+        return false;
+    }
+    const long v = NTL::conv<long>(c);
+    if (v * v > norm_bound_ - norm_) {
+        rejected_ = true;
+        return false;
+    }
+    norm_ += v * v;
+
+    pending_.push_back(static_cast<int32_t>(v));
+    if (pending_.size() == kStreamBlock) {
+        flush();
+    }
+    return true;
+}
+
+void StreamingVerifier::flush() {
+    if (pending_.empty()) {
+        return;
+    }
+    const long count = static_cast<long>(pending_.size());
+    if (proof_.native_) {
+        small_matvec_columns(proof_.native_matrix(), flushed_, pending_.data(), count, acc_native_.data());
+    } else {
+        NTL::ZZ_p term;
+        for (long i = 0; i < acc_.length(); i++) {
+            for (long j = 0; j < count; j++) {
+                NTL::mul(term, proof_.A_[i][flushed_ + j], pending_[j]);
+                acc_[i] += term;
+            }
+        }
+    }
+    flushed_ += count;
+    pending_.clear();
+}
+
+bool StreamingVerifier::feed(const NTL::vec_ZZ& chunk) {
+    AllocPhaseScope phase(AllocPhase::Verify);
+    if (!active_) {
+        throw std::logic_error("Streaming verification has not begun");
+    }
+    for (long j = 0; j < chunk.length() && !rejected_; j++) {
+        push(chunk[j]);
+    }
+    return !rejected_;
+}
+
+bool StreamingVerifier::feed(const uint8_t* data, size_t len) {
+    AllocPhaseScope phase(AllocPhase::Verify);
+    if (!active_) {
+        throw std::logic_error("Streaming verification has not begun");
+    }
+    const size_t width = static_cast<size_t>(NTL::NumBytes(proof_.parameters().q()));
+    size_t pos = 0;
+    if (!partial_.empty()) {
+        const size_t take = std::min(width - partial_.size(), len);
+        partial_.insert(partial_.end(), data, data + take);
+        pos = take;
+        if (partial_.size() < width) {
+            return !rejected_;
+        }
+        if (!rejected_) {
+            push(NTL::ZZFromBytes(partial_.data(), static_cast<long>(width)));
+        }
+        partial_.clear();
+    }
+    for (; pos + width <= len && !rejected_; pos += width) {
+        push(NTL::ZZFromBytes(data + pos, static_cast<long>(width)));
+    }
+    if (!rejected_ && pos < len) {
+        partial_.assign(data + pos, data + len);
+    }
+    return !rejected_;
+}
+
+bool StreamingVerifier::finish() {
+    AllocPhaseScope phase(AllocPhase::Verify);
+    if (!active_) {
+        throw std::logic_error("Streaming verification has not begun");
+    }
+    active_ = false;
+    if (rejected_) {
+        return false;
+    }
+    if (consumed_ != proof_.parameters().m() || !partial_.empty()) {
+        throw std::invalid_argument("Response vector has wrong dimension");
+    }
+    flush();
+
+    NTL::vec_ZZ_p w = proof_.native_ ? from_native(acc_native_.data(), proof_.parameters().n()) : acc_;
+    for (long i = 0; i < w.length(); i++) {
+        w[i] -= ct_[i];
+    }
+    return w == u_;
+}
+
+} // namespace protocol
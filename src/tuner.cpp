@@ -0,0 +1,381 @@
+#include "protocol/tuner.hpp"
+#include "protocol/utils.hpp"
+#include <NTL/mat_ZZ_p.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace protocol {
+
+namespace {
+
+const char* const kCacheHeader = "# lattice_zkp kernel plans v1";
+
+// Best-of timing of run() per vector, repeated for at least ~20ms
+double seconds_per_vector(const std::function<void()>& run, long count) {
+    using Clock = std::chrono::steady_clock;
+    run();  // warm caches and thread start-up paths
+    double best = std::numeric_limits<double>::infinity();
+    double total = 0;
+    for (int reps = 0; reps < 3 || (total < 0.02 && reps < 1000); reps++) {
+        auto start = Clock::now();
+        run();
+        double t = std::chrono::duration<double>(Clock::now() - start).count();
+        best = std::min(best, t);
+        total += t;
+    }
+    return best / count;
+}
+
+// mkdir -p for the directory part of path
+void make_parent_dirs(const std::string& path) {
+    for (size_t pos = path.find('/', 1); pos != std::string::npos; pos = path.find('/', pos + 1)) {
+        ::mkdir(path.substr(0, pos).c_str(), 0755);
+    }
+}
+
+struct PlanRegistry {
+    std::mutex mutex;
+    AutotuneMode mode = autotune_mode_from_env(AutotuneMode::Off);
+    std::string path = default_kernel_cache_path();
+    bool loaded = false;
+    KernelPlanCache cache;
+};
+
+PlanRegistry& registry() {
+    static PlanRegistry r;
+    return r;
+}
+
+} // namespace
+
+const char* kernel_name(MatvecKernel kernel) {
+    switch (kernel) {
+        case MatvecKernel::Scalar: return "scalar";
+        case MatvecKernel::Blocked: return "blocked";
+        case MatvecKernel::Avx2: return "avx2";
+        case MatvecKernel::Threaded: return "threaded";
+        case MatvecKernel::Fma: return "fma";
+    }
+    return "unknown";
+}
+
+bool kernel_from_name(const std::string& name, MatvecKernel& kernel) {
+    for (MatvecKernel k : {MatvecKernel::Scalar, MatvecKernel::Blocked,
+                           MatvecKernel::Avx2, MatvecKernel::Threaded, MatvecKernel::Fma}) {
+        if (name == kernel_name(k)) {
+            kernel = k;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool kernel_available(MatvecKernel kernel, uint32_t q) {
+    switch (kernel) {
+        case MatvecKernel::Avx2: return avx2_available() && avx2_supports_modulus(q);
+        case MatvecKernel::Threaded: return std::thread::hardware_concurrency() > 1;
+        case MatvecKernel::Fma: return fma_available();
+        default: return true;
+    }
+}
+
+void plan_matvec(const KernelPlan& plan, const NativeMatrix& M, const int32_t* v,
+                 long count, uint32_t* out, const PanelMatrix* panels) {
+    switch (plan.kernel) {
+        case MatvecKernel::Fma: {
+            int64_t max_abs = 0;
+            for (long j = 0; j < M.cols * count; j++) {
+                max_abs = std::max<int64_t>(max_abs, std::llabs(v[j]));
+            }
+            if (fma_exact_terms(M.q, max_abs) < M.cols) {
+                small_matvec_batch(M, v, count, out);
+            } else if (panels && panels->rows == M.rows && panels->cols == M.cols) {
+                fma_matvec(*panels, v, count, out);
+            } else {
+                fma_matvec(to_panels(M), v, count, out);
+            }
+            return;
+        }
+        case MatvecKernel::Blocked:
+            small_matvec_blocked(M, v, count, out);
+            return;
+        case MatvecKernel::Avx2:
+            small_matvec_avx2(M, v, count, out);
+            return;
+        case MatvecKernel::Threaded:
+            small_matvec_threaded(M, v, count, out, plan.threads);
+            return;
+        default:
+            small_matvec_batch(M, v, count, out);
+            return;
+    }
+}
+
+TuningResult tune_kernels(long rows, long cols, const NTL::ZZ& q) {
+    if (!fits_native(q) || rows <= 0 || cols <= 0) {
+        throw std::invalid_argument("Kernel tuning needs a positive shape and q < 2^32");
+    }
+    NativeMatrix M;
+    M.rows = rows;
+    M.cols = cols;
+    M.q = static_cast<uint32_t>(NTL::conv<long>(q));
+    M.data.resize(rows * cols);
+
+    // Timing data only, so a private generator: tuning must not move the NTL
+    // stream that keys and masks are drawn from
+    std::mt19937 rng(0x6c7a6b70);
+    std::uniform_int_distribution<uint32_t> entry(0, M.q - 1);
+    for (auto& a : M.data) {
+        a = entry(rng);
+    }
+
+    // Mask-sized coefficients, batched as prove() would
+    const long max_batch = 8;
+    std::vector<int32_t> v(max_batch * cols);
+    std::uniform_int_distribution<int32_t> mask(-10, 10);
+    for (auto& x : v) {
+        x = mask(rng);
+    }
+    std::vector<uint32_t> out(max_batch * rows);
+    const PanelMatrix panels = kernel_available(MatvecKernel::Fma, M.q) ? to_panels(M) : PanelMatrix();
+
+    TuningResult result;
+    std::vector<KernelPlan> candidates;
+    for (MatvecKernel k : {MatvecKernel::Scalar, MatvecKernel::Blocked, MatvecKernel::Avx2,
+                           MatvecKernel::Fma}) {
+        if (kernel_available(k, M.q)) {
+            KernelPlan plan;
+            plan.kernel = k;
+            candidates.push_back(plan);
+        }
+    }
+    if (kernel_available(MatvecKernel::Threaded, M.q)) {
+        const unsigned hw = std::thread::hardware_concurrency();
+        for (unsigned t = 2; t <= hw && 2 * t <= static_cast<unsigned long>(rows); t *= 2) {
+            KernelPlan plan;
+            plan.kernel = MatvecKernel::Threaded;
+            plan.threads = t;
+            candidates.push_back(plan);
+        }
+    }
+
+    double best = std::numeric_limits<double>::infinity();
+    for (const auto& plan : candidates) {
+        double t = seconds_per_vector([&] { plan_matvec(plan, M, v.data(), 1, out.data(), &panels); }, 1);
+        std::string name = kernel_name(plan.kernel);
+        if (plan.kernel == MatvecKernel::Threaded) {
+            name += " x" + std::to_string(plan.threads);
+        }
+        result.timings.emplace_back(name, t);
+        if (t < best) {
+            best = t;
+            result.plan = plan;
+        }
+    }
+
+    // Largest batch that still pays for itself (at least 5% per vector)
+    result.plan.batch = 1;
+    double per_vector = best;
+    for (long count = 2; count <= max_batch; count *= 2) {
+        double t = seconds_per_vector(
+            [&] { plan_matvec(result.plan, M, v.data(), count, out.data(), &panels); }, count);
+        result.timings.emplace_back("batch " + std::to_string(count), t);
+        if (t < 0.95 * per_vector) {
+            per_vector = t;
+            result.plan.batch = count;
+        }
+    }
+
+    // NTL reference as a baseline; the native kernels compute the same product
+    {
+        NTL::ZZ_pPush push(q);
+        NTL::mat_ZZ_p A;
+        A.SetDims(rows, cols);
+        for (long i = 0; i < rows; i++) {
+            for (long j = 0; j < cols; j++) {
+                A[i][j] = NTL::conv<NTL::ZZ_p>(static_cast<long>(M.row(i)[j]));
+            }
+        }
+        NTL::vec_ZZ x;
+        x.SetLength(cols);
+        for (long j = 0; j < cols; j++) {
+            x[j] = v[j];
+        }
+        result.timings.emplace_back("ntl", seconds_per_vector([&] { matrix_vector_mod(A, x); }, 1));
+    }
+    return result;
+}
+
+std::string cpu_model() {
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    std::string model = "unknown";
+    while (std::getline(in, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                model = line.substr(line.find_first_not_of(" \t", colon + 1));
+            }
+            break;
+        }
+    }
+    return model + " x" + std::to_string(std::thread::hardware_concurrency());
+}
+
+bool KernelPlanCache::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string cpu, rows, cols, bits, kernel, threads, batch;
+        if (!std::getline(fields, cpu, '\t') || !std::getline(fields, rows, '\t') ||
+            !std::getline(fields, cols, '\t') || !std::getline(fields, bits, '\t') ||
+            !std::getline(fields, kernel, '\t') || !std::getline(fields, threads, '\t') ||
+            !std::getline(fields, batch)) {
+            continue;
+        }
+        KernelPlan plan;
+        try {
+            if (!kernel_from_name(kernel, plan.kernel)) {
+                continue;
+            }
+            plan.threads = static_cast<unsigned>(std::max(1L, std::stol(threads)));
+            plan.batch = std::max(1L, std::stol(batch));
+            store(cpu, std::stol(rows), std::stol(cols), std::stol(bits), plan);
+        } catch (const std::exception&) {
+            continue;
+        }
+    }
+    return true;
+}
+
+bool KernelPlanCache::save(const std::string& path) const {
+    // Write a uniquely named sibling and rename it, so concurrent readers never
+    // see a torn cache and concurrent writers never share a temporary
+    make_parent_dirs(path);
+    std::string tmp = path + ".XXXXXX";
+    const int fd = ::mkstemp(&tmp[0]);
+    if (fd < 0) {
+        return false;
+    }
+    ::close(fd);
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        if (!out) {
+            std::remove(tmp.c_str());
+            return false;
+        }
+        out << kCacheHeader << "\n";
+        for (const auto& [key, plan] : plans_) {
+            const auto& [cpu, rows, cols, bits] = key;
+            out << cpu << '\t' << rows << '\t' << cols << '\t' << bits << '\t'
+                << kernel_name(plan.kernel) << '\t' << plan.threads << '\t' << plan.batch << "\n";
+        }
+        if (!out) {
+            std::remove(tmp.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool KernelPlanCache::lookup(const std::string& cpu, long rows, long cols, long q_bits,
+                             KernelPlan& plan) const {
+    auto it = plans_.find(std::make_tuple(cpu, rows, cols, q_bits));
+    if (it == plans_.end()) {
+        return false;
+    }
+    plan = it->second;
+    return true;
+}
+
+void KernelPlanCache::store(const std::string& cpu, long rows, long cols, long q_bits,
+                            const KernelPlan& plan) {
+    plans_[std::make_tuple(cpu, rows, cols, q_bits)] = plan;
+}
+
+void set_autotune(AutotuneMode mode, const std::string& cache_path) {
+    PlanRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.mode = mode;
+    r.path = cache_path.empty() ? default_kernel_cache_path() : cache_path;
+    r.loaded = false;
+    r.cache = KernelPlanCache();
+}
+
+AutotuneMode autotune_mode_from_env(AutotuneMode fallback) {
+    const char* env = std::getenv("LATTICE_ZKP_AUTOTUNE");
+    std::string mode = env ? env : "";
+    if (mode == "off") return AutotuneMode::Off;
+    if (mode == "cached") return AutotuneMode::Cached;
+    if (mode == "tune") return AutotuneMode::Tune;
+    return fallback;
+}
+
+std::string default_kernel_cache_path() {
+    if (const char* path = std::getenv("LATTICE_ZKP_KERNEL_CACHE")) {
+        return path;
+    }
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME")) {
+        return std::string(xdg) + "/lattice_zkp/kernels.tsv";
+    }
+    if (const char* home = std::getenv("HOME")) {
+        return std::string(home) + "/.cache/lattice_zkp/kernels.tsv";
+    }
+    return "lattice_zkp_kernels.tsv";
+}
+
+KernelPlan kernel_plan(long rows, long cols, const NTL::ZZ& q) {
+    PlanRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    KernelPlan plan;
+    if (r.mode == AutotuneMode::Off || !fits_native(q)) {
+        return plan;
+    }
+    if (!r.loaded) {
+        r.cache.load(r.path);
+        r.loaded = true;
+    }
+
+    const std::string cpu = cpu_model();
+    const long bits = NTL::NumBits(q);
+    if (r.cache.lookup(cpu, rows, cols, bits, plan)) {
+        // A cache copied from another host or an older build may name a kernel
+        // this process cannot run
+        if (!kernel_available(plan.kernel, static_cast<uint32_t>(NTL::conv<long>(q)))) {
+            plan = KernelPlan();
+        }
+        return plan;
+    }
+    if (r.mode == AutotuneMode::Tune) {
+        plan = tune_kernels(rows, cols, q).plan;
+        // Merge with whatever other processes have cached meanwhile
+        r.cache.load(r.path);
+        r.cache.store(cpu, rows, cols, bits, plan);
+        r.cache.save(r.path);
+    }
+    return plan;
+}
+
+} // namespace protocol
@@ -1,9 +1,18 @@
 #include "protocol/utils.hpp"
+#include "protocol/hash.hpp"
+#include "protocol/reduction.hpp"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
 namespace protocol {
 
+namespace {
+
+const char kMatrixDomain[] = "lattice_zkp/matrix";
+
+} // namespace
+
 NTL::vec_ZZ sample_ternary(int length) {
     NTL::vec_ZZ result;
     result.SetLength(length);
@@ -22,6 +31,78 @@ NTL::vec_ZZ sample_uniform(int length, long bound) {
     return result;
 }
 
+NTL::mat_ZZ_p expand_matrix(const MatrixSeed& seed, long rows, long cols) {
+    const NTL::ZZ& q = NTL::ZZ_p::modulus();
+    const long width = NTL::NumBytes(q);
+    const long bits = NTL::NumBits(q);
+    const bool small = bits <= 62;
+    const uint64_t q_small = small ? static_cast<uint64_t>(NTL::conv<long>(q)) : 0;
+    const uint64_t mask = small ? (uint64_t(1) << bits) - 1 : 0;
+
+    NTL::mat_ZZ_p A;
+    A.SetDims(rows, cols);
+    const long group = 8;
+    for (long first = 0; first < rows; first += group) {
+        const size_t count = static_cast<size_t>(std::min(group, rows - first));
+        ShakeMany xof(128, count);
+        xof.absorb_shared(reinterpret_cast<const uint8_t*>(kMatrixDomain), sizeof(kMatrixDomain) - 1);
+        xof.absorb_shared(seed.data(), seed.size());
+        std::vector<std::array<uint8_t, 4>> index(count);
+        std::vector<const uint8_t*> in(count);
+        for (size_t k = 0; k < count; k++) {
+            const uint32_t i = static_cast<uint32_t>(first + k);
+            index[k] = {uint8_t(i), uint8_t(i >> 8), uint8_t(i >> 16), uint8_t(i >> 24)};
+            in[k] = index[k].data();
+        }
+        xof.absorb(in.data(), 4);
+
+        // Squeeze a block for every row of the group until all rows are full;
+        // candidates are width-byte little-endian words cut to bits(q) bits
+        const size_t rate = xof.rate();
+        std::vector<uint8_t> block(count * rate);
+        std::vector<uint8_t*> out(count);
+        std::vector<std::vector<uint8_t>> pending(count);
+        std::vector<long> filled(count, 0);
+        size_t open = cols > 0 ? count : 0;
+        while (open > 0) {
+            for (size_t k = 0; k < count; k++) {
+                out[k] = block.data() + k * rate;
+            }
+            xof.squeeze(out.data(), rate);
+            for (size_t k = 0; k < count; k++) {
+                if (filled[k] == cols) {
+                    continue;
+                }
+                std::vector<uint8_t>& buf = pending[k];
+                buf.insert(buf.end(), out[k], out[k] + rate);
+                size_t pos = 0;
+                for (; filled[k] < cols && pos + width <= buf.size(); pos += width) {
+                    if (small) {
+                        uint64_t x = 0;
+                        for (long b = width - 1; b >= 0; b--) {
+                            x = (x << 8) | buf[pos + b];
+                        }
+                        x &= mask;
+                        if (x < q_small) {
+                            A[first + k][filled[k]++] = NTL::conv<NTL::ZZ_p>(static_cast<long>(x));
+                        }
+                    } else {
+                        NTL::ZZ x = NTL::trunc_ZZ(NTL::ZZFromBytes(buf.data() + pos, width), bits);
+                        if (x < q) {
+                            A[first + k][filled[k]++] = NTL::conv<NTL::ZZ_p>(x);
+                        }
+                    }
+                }
+                buf.erase(buf.begin(), buf.begin() + pos);
+                if (filled[k] == cols) {
+                    open--;
+                }
+            }
+        }
+    }
+    return A;
+}
+
 NTL::vec_ZZ_p matrix_vector_mod(const NTL::mat_ZZ_p& M, const NTL::vec_ZZ& v) {
     NTL::vec_ZZ_p v_mod;
     v_mod.SetLength(v.length());
@@ -41,6 +122,77 @@ NTL::ZZ compute_norm_squared(const NTL::vec_ZZ& v, const NTL::ZZ& q) {
     return norm_sq;
 }
 
+bool fits_native(const NTL::ZZ& q) {
+    return NTL::NumBits(q) <= 32;
+}
+
+NativeMatrix to_native(const NTL::mat_ZZ_p& M) {
+    NativeMatrix native;
+    native.rows = M.NumRows();
+    native.cols = M.NumCols();
+    native.q = static_cast<uint32_t>(NTL::conv<long>(NTL::ZZ_p::modulus()));
+    native.data.resize(native.rows * native.cols);
+    for (long i = 0; i < native.rows; i++) {
+        for (long j = 0; j < native.cols; j++) {
+            native.data[i * native.cols + j] = static_cast<uint32_t>(NTL::conv<long>(rep(M[i][j])));
+        }
+    }
+    return native;
+}
+
+std::vector<int32_t> to_centered(const NTL::vec_ZZ& v, const NTL::ZZ& q) {
+    const long ql = NTL::conv<long>(q);
+    const Reducer r(static_cast<uint32_t>(ql));
+    std::vector<int32_t> result(v.length());
+    for (long i = 0; i < v.length(); i++) {
+        // Word-sized entries (all of an honest z) reduce without NTL division
+        long vi = NTL::NumBits(v[i]) < 64 ? r.reduce_signed(NTL::conv<long>(v[i]))
+                                          : NTL::conv<long>(v[i] % q);  // in [0, q)
+        if (vi > ql / 2) vi -= ql;
+        result[i] = static_cast<int32_t>(vi);
+    }
+    return result;
+}
+
+bool to_ternary(const NTL::vec_ZZ& v, std::vector<int8_t>& out) {
+    out.resize(v.length());
+    for (long i = 0; i < v.length(); i++) {
+        if (v[i] < -1 || v[i] > 1) return false;
+        out[i] = static_cast<int8_t>(NTL::conv<long>(v[i]));
+    }
+    return true;
+}
+
+bool to_small_centered(const NTL::vec_ZZ& v, const NTL::ZZ& q, long bound,
+                       std::vector<int32_t>& out) {
+    out.resize(v.length());
+    for (long i = 0; i < v.length(); i++) {
+        NTL::ZZ vi = v[i] % q;
+        if (vi > q / 2) vi -= q;
+        if (vi > bound || vi < -bound) return false;
+        out[i] = static_cast<int32_t>(NTL::conv<long>(vi));
+    }
+    return true;
+}
+
+NTL::vec_ZZ_p from_native(const uint32_t* v, long length) {
+    NTL::vec_ZZ_p result;
+    result.SetLength(length);
+    for (long i = 0; i < length; i++) {
+        result[i] = NTL::conv<NTL::ZZ_p>(static_cast<long>(v[i]));
+    }
+    return result;
+}
+
+std::vector<uint8_t> to_bytes(const NTL::vec_ZZ_p& v) {
+    const long width = NTL::NumBytes(NTL::ZZ_p::modulus());
+    std::vector<uint8_t> bytes(v.length() * width);
+    for (long i = 0; i < v.length(); i++) {
+        NTL::BytesFromZZ(bytes.data() + i * width, rep(v[i]), width);
+    }
+    return bytes;
+}
+
 long calculate_norm_bound(int m, int y_range, int s_range, double safety_factor) {
     double E_y_squared = calculate_expected_y_contribution(m, y_range);
     double E_s_squared = calculate_expected_s_contribution(m, s_range);
@@ -48,6 +200,14 @@ long calculate_norm_bound(int m, int y_range, int s_range, double safety_factor)
     return static_cast<long>(ceil(safety_factor * expected_norm_squared));
 }
 
+long calculate_sparse_norm_bound(int m, int weight, int y_range, int s_range,
+                                 double safety_factor) {
+    // Only the weight nonzero coordinates of c pick up a contribution from s
+    double E_y_squared = calculate_expected_y_contribution(m, y_range);
+    double E_s_squared = calculate_expected_s_contribution(weight, s_range);
+    return static_cast<long>(ceil(safety_factor * (E_y_squared + E_s_squared)));
+}
+
 double calculate_expected_y_contribution(int m, int y_range) {
     return m * (pow(y_range, 2) - 1) / 3.0;
 }
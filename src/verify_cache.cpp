@@ -0,0 +1,219 @@
+#include "protocol/verify_cache.hpp"
+#include "protocol/hash.hpp"
+#include "protocol/utils.hpp"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace protocol {
+
+namespace {
+
+const char kTranscriptDomain[] = "lattice_zkp/transcript";
+const char kProofDomain[] = "lattice_zkp/ni_proof";
+
+void absorb_length(Shake& xof, uint64_t n) {
+    uint8_t bytes[8];
+    for (int b = 0; b < 8; b++) {
+        bytes[b] = static_cast<uint8_t>(n >> (8 * b));
+    }
+    xof.absorb(bytes, sizeof(bytes));
+}
+
+// Exact integers: sign, magnitude length and magnitude per coefficient. verify()
+// reads z and c as given (the norm check centers z by one subtraction only),
+// so representatives that agree mod q must still hash apart.
+void absorb_integers(Shake& xof, const NTL::vec_ZZ& v) {
+    absorb_length(xof, v.length());
+    std::vector<uint8_t> bytes;
+    for (long j = 0; j < v.length(); j++) {
+        const NTL::ZZ magnitude = NTL::abs(v[j]);
+        const long width = NTL::NumBytes(magnitude);
+        bytes.resize(9 + width);
+        bytes[0] = NTL::sign(v[j]) < 0 ? 1 : 0;
+        for (int b = 0; b < 8; b++) {
+            bytes[1 + b] = static_cast<uint8_t>(static_cast<uint64_t>(width) >> (8 * b));
+        }
+        NTL::BytesFromZZ(bytes.data() + 9, magnitude, width);
+        xof.absorb(bytes.data(), bytes.size());
+    }
+}
+
+void absorb_residues(Shake& xof, const NTL::vec_ZZ_p& v) {
+    std::vector<uint8_t> bytes = to_bytes(v);
+    absorb_length(xof, v.length());
+    xof.absorb(bytes.data(), bytes.size());
+}
+
+struct DigestHash {
+    size_t operator()(const TranscriptDigest& d) const {
+        size_t h;
+        std::memcpy(&h, d.data() + 8, sizeof(h));  // bytes 0-7 pick the shard
+        return h;
+    }
+};
+
+} // namespace
+
+TranscriptDigest transcript_digest(const LatticeProof& proof, const Transcript& t) {
+    Shake xof(256);
+    xof.absorb(reinterpret_cast<const uint8_t*>(kTranscriptDomain), sizeof(kTranscriptDomain) - 1);
+    xof.absorb(proof.key_digest().data(), proof.key_digest().size());
+    absorb_residues(xof, t.u);
+    absorb_integers(xof, t.challenge);
+    absorb_integers(xof, t.z);
+    TranscriptDigest digest;
+    xof.squeeze(digest.data(), digest.size());
+    return digest;
+}
+
+TranscriptDigest transcript_digest(const LatticeProof& proof, const NonInteractiveProof& p) {
+    Shake xof(256);
+    xof.absorb(reinterpret_cast<const uint8_t*>(kProofDomain), sizeof(kProofDomain) - 1);
+    xof.absorb(proof.key_digest().data(), proof.key_digest().size());
+    xof.absorb(p.digest.data(), p.digest.size());
+    absorb_integers(xof, p.z);
+    TranscriptDigest digest;
+    xof.squeeze(digest.data(), digest.size());
+    return digest;
+}
+
+struct alignas(64) VerifyCache::Shard {
+    struct Slot {
+        TranscriptDigest key;
+        bool accepted = false;
+        bool referenced = false;
+        bool used = false;
+    };
+
+    std::mutex mutex;
+    std::vector<Slot> slots;
+    std::unordered_map<TranscriptDigest, size_t, DigestHash> index;
+    size_t hand = 0;
+    VerifyCacheStats stats;
+};
+
+VerifyCache::VerifyCache(size_t capacity, size_t shards)
+    : capacity_(capacity) {
+    if (capacity == 0 || shards == 0) {
+        throw std::invalid_argument("Verify cache needs a positive capacity and shard count");
+    }
+    shards = std::min(shards, capacity);
+    for (size_t k = 0; k < shards; k++) {
+        shards_.push_back(std::make_unique<Shard>());
+        // Split capacity exactly, earlier shards taking the remainder
+        shards_.back()->slots.resize(capacity / shards + (k < capacity % shards ? 1 : 0));
+        shards_.back()->index.reserve(shards_.back()->slots.size());
+    }
+}
+
+VerifyCache::~VerifyCache() = default;
+
+VerifyCache::Shard& VerifyCache::shard(const TranscriptDigest& key) {
+    uint64_t h;
+    std::memcpy(&h, key.data(), sizeof(h));
+    return *shards_[h % shards_.size()];
+}
+
+bool VerifyCache::lookup(const TranscriptDigest& key, bool& accepted) {
+    Shard& s = shard(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto it = s.index.find(key);
+    if (it == s.index.end()) {
+        s.stats.misses++;
+        return false;
+    }
+    Shard::Slot& slot = s.slots[it->second];
+    slot.referenced = true;
+    accepted = slot.accepted;
+    s.stats.hits++;
+    return true;
+}
+
+void VerifyCache::insert(const TranscriptDigest& key, bool accepted) {
+    Shard& s = shard(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto it = s.index.find(key);
+    if (it != s.index.end()) {
+        s.slots[it->second].accepted = accepted;
+        return;
+    }
+
+    // CLOCK: clear reference bits until an unused or unreferenced slot comes up
+    for (;;) {
+        Shard::Slot& slot = s.slots[s.hand];
+        if (!slot.used || !slot.referenced) {
+            break;
+        }
+        slot.referenced = false;
+        s.hand = (s.hand + 1) % s.slots.size();
+    }
+    Shard::Slot& slot = s.slots[s.hand];
+    if (slot.used) {
+        s.index.erase(slot.key);
+        s.stats.evictions++;
+    }
+    slot.key = key;
+    slot.accepted = accepted;
+    slot.referenced = false;
+    slot.used = true;
+    s.index.emplace(key, s.hand);
+    s.hand = (s.hand + 1) % s.slots.size();
+    s.stats.insertions++;
+}
+
+void VerifyCache::clear() {
+    for (auto& s : shards_) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        for (auto& slot : s->slots) {
+            slot = Shard::Slot();
+        }
+        s->index.clear();
+        s->hand = 0;
+    }
+}
+
+size_t VerifyCache::size() const {
+    size_t n = 0;
+    for (const auto& s : shards_) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        n += s->index.size();
+    }
+    return n;
+}
+
+VerifyCacheStats VerifyCache::stats() const {
+    VerifyCacheStats total;
+    for (const auto& s : shards_) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        total.hits += s->stats.hits;
+        total.misses += s->stats.misses;
+        total.insertions += s->stats.insertions;
+        total.evictions += s->stats.evictions;
+    }
+    return total;
+}
+
+bool verify_cached(const LatticeProof& proof, VerifyCache& cache, const Transcript& t) {
+    const TranscriptDigest key = transcript_digest(proof, t);
+    bool accepted;
+    if (!cache.lookup(key, accepted)) {
+        accepted = proof.verify(t.u, t.challenge, t.z);
+        cache.insert(key, accepted);
+    }
+    return accepted;
+}
+
+bool verify_cached(const LatticeProof& proof, VerifyCache& cache, const NonInteractiveProof& p) {
+    const TranscriptDigest key = transcript_digest(proof, p);
+    bool accepted;
+    if (!cache.lookup(key, accepted)) {
+        accepted = proof.verify(p);
+        cache.insert(key, accepted);
+    }
+    return accepted;
+}
+
+} // namespace protocol
@@ -0,0 +1,251 @@
+#include "protocol/workspace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+
+namespace protocol {
+
+namespace {
+
+void check_ternary(Span<const int8_t> c) {
+    for (int8_t cj : c) {
+        if (cj < -1 || cj > 1) {
+            throw std::invalid_argument("Challenge coefficients must be in {-1,0,1}");
+        }
+    }
+}
+
+// ||z||^2 <= bound, stopping at the first coefficient that exceeds it
+bool within_norm(Span<const int32_t> z, long bound) {
+    int64_t norm_sq = 0;
+    for (int32_t zj : z) {
+        norm_sq += static_cast<int64_t>(zj) * zj;
+        if (norm_sq > bound) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void record_attempt(RejectionStats& stats, bool accepted, double seconds) {
+    stats.attempts++;
+    stats.max_attempts = std::max<uint64_t>(stats.max_attempts, 1);
+    stats.seconds += seconds;
+    if (accepted) {
+        stats.accepted++;
+    } else {
+        stats.retry_seconds += seconds;
+    }
+}
+
+} // namespace
+
+Workspace::Workspace(const Parameters& params, std::pmr::memory_resource* resource)
+    : n_(params.n()),
+      m_(params.m()),
+      y_(params.m(), resource),
+      cs_(params.m(), resource),
+      pos_((params.m() + 63) / 64, resource),
+      neg_((params.m() + 63) / 64, resource),
+      ct_(params.n(), resource),
+      w_(params.n(), resource) {}
+
+void LatticeProof::check_workspace(const Workspace& ws) const {
+    if (!native_) {
+        throw std::invalid_argument("Span overloads need a modulus below 2^32");
+    }
+    if (ws.n_ != params_.n() || ws.m_ != params_.m()) {
+        throw std::invalid_argument("Workspace dimensions do not match the parameters");
+    }
+}
+
+void LatticeProof::commit(Workspace& ws, Span<uint32_t> u) const {
+    AllocPhaseScope phase(AllocPhase::Commit);
+    check_workspace(ws);
+    if (static_cast<long>(u.size()) != params_.n()) {
+        throw std::invalid_argument("Commitment vector has wrong dimension");
+    }
+    const long bound = params_.y_range();
+    for (int32_t& yj : ws.y_) {
+        yj = static_cast<int32_t>(NTL::RandomBnd(2 * bound + 1) - bound);
+    }
+    plan_matvec(plan_, native_matrix(), ws.y_.data(), 1, u.data(), panel_matrix());
+    ws.armed_ = true;
+}
+
+void LatticeProof::respond(Workspace& ws, Span<const int8_t> challenge, Span<int32_t> z) const {
+    AllocPhaseScope phase(AllocPhase::Respond);
+    check_workspace(ws);
+    if (static_cast<long>(challenge.size()) != params_.m()) {
+        throw std::invalid_argument("Challenge vector has wrong dimension");
+    }
+    if (static_cast<long>(z.size()) != params_.m()) {
+        throw std::invalid_argument("Response vector has wrong dimension");
+    }
+    if (!ws.armed_) {
+        throw std::logic_error("commit() must be called before respond()");
+    }
+    check_ternary(challenge);
+    for (int j = 0; j < params_.m(); j++) {
+        z[j] = ws.y_[j] + challenge[j] * s_ternary_[j];
+    }
+}
+
+void LatticeProof::respond(Workspace& ws, const SparseChallenge& challenge, Span<int32_t> z) const {
+    AllocPhaseScope phase(AllocPhase::Respond);
+    check_workspace(ws);
+    validate_challenge(challenge, params_.m(), params_.challenge_weight());
+    if (static_cast<long>(z.size()) != params_.m()) {
+        throw std::invalid_argument("Response vector has wrong dimension");
+    }
+    if (!ws.armed_) {
+        throw std::logic_error("commit() must be called before respond()");
+    }
+    std::copy(ws.y_.begin(), ws.y_.end(), z.begin());
+    for (int k = 0; k < challenge.weight(); k++) {
+        const int32_t j = challenge.index[k];
+        z[j] += challenge.sign[k] * s_ternary_[j];
+    }
+}
+
+bool LatticeProof::try_respond(Workspace& ws, Span<const int8_t> challenge, Span<int32_t> z) const {
+    AllocPhaseScope phase(AllocPhase::Respond);
+    check_workspace(ws);
+    if (static_cast<long>(challenge.size()) != params_.m()) {
+        throw std::invalid_argument("Challenge vector has wrong dimension");
+    }
+    check_ternary(challenge);
+    long norm_bound = calculate_norm_bound(
+        params_.m(), params_.y_range(), params_.s_range(), params_.safety_factor()
+    );
+    return accept_span(ws, challenge.data(), norm_bound, z);
+}
+
+bool LatticeProof::try_respond(Workspace& ws, const SparseChallenge& challenge, Span<int32_t> z) const {
+    AllocPhaseScope phase(AllocPhase::Respond);
+    check_workspace(ws);
+    validate_challenge(challenge, params_.m(), params_.challenge_weight());
+    std::fill(ws.cs_.begin(), ws.cs_.end(), 0);
+    for (int k = 0; k < challenge.weight(); k++) {
+        ws.cs_[challenge.index[k]] = challenge.sign[k];
+    }
+    long norm_bound = calculate_sparse_norm_bound(
+        params_.m(), challenge.weight(), params_.y_range(), params_.s_range(),
+        params_.safety_factor()
+    );
+    return accept_span(ws, ws.cs_.data(), norm_bound, z);
+}
+
+bool LatticeProof::accept_span(Workspace& ws, const int8_t* c, long norm_bound,
+                               Span<int32_t> z) const {
+    if (static_cast<long>(z.size()) != params_.m()) {
+        throw std::invalid_argument("Response vector has wrong dimension");
+    }
+    if (!ws.armed_) {
+        throw std::logic_error("commit() must be called before respond()");
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    // Same test as accept_response; z is cleared if the candidate is dropped
+    const int64_t bound = params_.rejection_sampling()
+        ? params_.rejection_bound()
+        : std::numeric_limits<int64_t>::max();
+    bool accepted = true;
+    int64_t norm_sq = 0;
+    for (int j = 0; j < params_.m() && accepted; j++) {
+        const int32_t zj = ws.y_[j] + c[j] * s_ternary_[j];
+        norm_sq += static_cast<int64_t>(zj) * zj;
+        accepted = !(c[j] != 0 && std::abs(zj) > bound) && norm_sq <= norm_bound;
+        z[j] = zj;
+    }
+    if (!accepted) {
+        std::fill(z.begin(), z.end(), 0);
+    }
+    // The mask is never reused, whether or not z was released
+    ws.armed_ = false;
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    record_attempt(ws.stats_, accepted, seconds);
+    return accepted;
+}
+
+bool LatticeProof::verify(Workspace& ws, Span<const uint32_t> u, Span<const int8_t> challenge,
+                          Span<const int32_t> z) const {
+    AllocPhaseScope phase(AllocPhase::Verify);
+    check_workspace(ws);
+    if (static_cast<long>(u.size()) != params_.n()) {
+        throw std::invalid_argument("Commitment vector has wrong dimension");
+    }
+    if (static_cast<long>(challenge.size()) != params_.m()) {
+        throw std::invalid_argument("Challenge vector has wrong dimension");
+    }
+    check_ternary(challenge);
+    if (static_cast<long>(z.size()) != params_.m()) {
+        throw std::invalid_argument("Response vector has wrong dimension");
+    }
+    long norm_bound = calculate_norm_bound(
+        params_.m(), params_.y_range(), params_.s_range(), params_.safety_factor()
+    );
+    if (!within_norm(z, norm_bound)) {
+        return false;
+    }
+
+    // ct = A(c*s); the entrywise product of ternary vectors is ternary
+    for (int j = 0; j < params_.m(); j++) {
+        ws.cs_[j] = static_cast<int8_t>(challenge[j] * s_ternary_[j]);
+    }
+    pack_ternary(ws.cs_.data(), params_.m(), ws.pos_.data(), ws.neg_.data());
+    ternary_matvec(native_matrix(), ws.pos_.data(), ws.neg_.data(), ws.ct_.data());
+    return matches_commitment(ws, u, z);
+}
+
+bool LatticeProof::verify(Workspace& ws, Span<const uint32_t> u, const SparseChallenge& challenge,
+                          Span<const int32_t> z) const {
+    AllocPhaseScope phase(AllocPhase::Verify);
+    check_workspace(ws);
+    if (static_cast<long>(u.size()) != params_.n()) {
+        throw std::invalid_argument("Commitment vector has wrong dimension");
+    }
+    validate_challenge(challenge, params_.m(), params_.challenge_weight());
+    if (static_cast<long>(z.size()) != params_.m()) {
+        throw std::invalid_argument("Response vector has wrong dimension");
+    }
+    long norm_bound = calculate_sparse_norm_bound(
+        params_.m(), challenge.weight(), params_.y_range(), params_.s_range(),
+        params_.safety_factor()
+    );
+    if (!within_norm(z, norm_bound)) {
+        return false;
+    }
+
+    const int weight = challenge.weight();
+    for (int k = 0; k < weight; k++) {
+        ws.cs_[k] = static_cast<int8_t>(challenge.sign[k] * s_ternary_[challenge.index[k]]);
+    }
+    sparse_matvec(native_matrix(), challenge.index.data(), ws.cs_.data(), weight, ws.ct_.data());
+    return matches_commitment(ws, u, z);
+}
+
+bool LatticeProof::matches_commitment(Workspace& ws, Span<const uint32_t> u,
+                                      Span<const int32_t> z) const {
+    // Az - ct == u; z has passed the norm check, so it is small
+    plan_matvec(plan_, native_matrix(), z.data(), 1, ws.w_.data(), panel_matrix());
+    const uint32_t q = A_native_.q;
+    for (int i = 0; i < params_.n(); i++) {
+        const uint32_t w = ws.w_[i];
+        const uint32_t ct = ws.ct_[i];
+        if ((w >= ct ? w - ct : w + (q - ct)) != u[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LatticeProof::generate_challenge(Span<int8_t> out) {
+    for (int8_t& c : out) {
+        c = static_cast<int8_t>(NTL::RandomBnd(3) - 1);
+    }
+}
+
+} // namespace protocol
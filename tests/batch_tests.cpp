@@ -0,0 +1,66 @@
+#include "test_utils.hpp"
+#include "protocol/batch.hpp"
+#include <vector>
+
+namespace test {
+
+void test_verify_many() {
+    std::cout << "\nTest: Parallel Batch Verification\n";
+
+    const NTL::ZZ q = NTL::conv<NTL::ZZ>("1073741789");
+    protocol::Parameters params(32, 64, q, 10, 1, 10.0, 1.5, 8, 15);
+    protocol::LatticeProof proof(params);
+
+    // Honest transcripts with every fifth response tampered: half of those
+    // fail the norm check early, the other half the full recomputation
+    const size_t count = 300;
+    std::vector<protocol::Transcript> transcripts(count);
+    std::vector<bool> expected(count);
+    for (size_t i = 0; i < count; i++) {
+        auto& t = transcripts[i];
+        t.u = proof.commit();
+        t.challenge = protocol::LatticeProof::generate_challenge(params.m());
+        t.z = proof.respond(t.challenge);
+        expected[i] = i % 5 != 0;
+        if (!expected[i]) {
+            t.z[i % params.m()] = i % 10 == 0 ? q / 2 : (t.z[i % params.m()] + 1) % q;
+        }
+    }
+    // A malformed transcript counts as rejected rather than aborting the batch
+    transcripts[7].z.SetLength(3);
+    expected[7] = false;
+
+    for (unsigned threads : {1u, 3u, 8u, 0u}) {
+        auto result = protocol::verify_many(proof, transcripts, threads);
+        assert(result.size == count);
+        for (size_t i = 0; i < count; i++) {
+            assert(result.accepted(i) == expected[i] && "Batch result disagrees with verify()");
+        }
+        std::cout << "  threads=" << threads << ": " << result.count() << "/" << count << " accepted\n";
+    }
+
+    // The caller's modulus is left as it was
+    NTL::ZZ_p::init(NTL::conv<NTL::ZZ>(97));
+    protocol::verify_many(proof, transcripts, 4);
+    assert(NTL::ZZ_p::modulus() == 97 && "verify_many changed the caller's modulus");
+    NTL::ZZ_p::init(q);
+
+    // Non-interactive proofs
+    std::vector<protocol::NonInteractiveProof> proofs;
+    for (int i = 0; i < 40; i++) {
+        proofs.push_back(proof.prove());
+    }
+    proofs[11].digest[0] ^= 1;
+    auto ni = protocol::verify_many(proof, proofs, 4);
+    assert(ni.count() == proofs.size() - 1 && !ni.accepted(11) && !ni.all());
+
+    assert(protocol::verify_many(proof, std::vector<protocol::Transcript>(), 4).all());
+
+    std::cout << "✓ Parallel batch verification test passed\n";
+}
+
+void run_batch_tests() {
+    test_verify_many();
+}
+
+} // namespace test
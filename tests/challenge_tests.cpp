@@ -0,0 +1,273 @@
+#include "test_utils.hpp"
+#include "protocol/hash.hpp"
+#include <array>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+namespace test {
+
+// SHAKE known-answer tests (FIPS 202, empty message)
+void test_shake() {
+    std::cout << "\nTest: SHAKE Known Answers\n";
+
+    const uint8_t expected128[8] = {0x7f, 0x9c, 0x2b, 0xa4, 0xe8, 0x8f, 0x82, 0x7d};
+    const uint8_t expected256[8] = {0x46, 0xb9, 0xdd, 0x2b, 0x0b, 0xa8, 0x8d, 0x13};
+    uint8_t out[8];
+
+    protocol::shake128(out, sizeof(out), nullptr, 0);
+    assert(std::memcmp(out, expected128, sizeof(out)) == 0 && "SHAKE128 mismatch");
+    protocol::shake256(out, sizeof(out), nullptr, 0);
+    assert(std::memcmp(out, expected256, sizeof(out)) == 0 && "SHAKE256 mismatch");
+
+    std::cout << "✓ SHAKE known-answer test passed\n";
+}
+
+// Multi-buffer permutations and SHAKE must match the one-state versions
+void test_multibuffer_keccak() {
+    std::cout << "\nTest: Multi-Buffer Keccak\n";
+    std::cout << "  Keccak parallelism: " << protocol::keccak_parallelism() << "\n";
+
+    uint64_t lanes[25 * 8];
+    for (int i = 0; i < 25 * 8; i++) {
+        lanes[i] = 0x9e3779b97f4a7c15ULL * (i + 1);
+    }
+    for (int width : {4, 8}) {
+        std::vector<uint64_t> batch(lanes, lanes + 25 * width);
+        width == 4 ? protocol::keccak_f1600_x4(batch.data()) : protocol::keccak_f1600_x8(batch.data());
+        for (int k = 0; k < width; k++) {
+            uint64_t st[25];
+            for (int i = 0; i < 25; i++) {
+                st[i] = lanes[i * width + k];
+            }
+            protocol::keccak_f1600(st);
+            for (int i = 0; i < 25; i++) {
+                assert(batch[i * width + k] == st[i] && "Multi-buffer permutation mismatch");
+            }
+        }
+    }
+
+    // Instance counts straddling group sizes, lengths straddling block edges
+    for (size_t count : {1, 3, 4, 5, 8, 11}) {
+        for (size_t len : {0, 1, 7, 135, 136, 137, 300}) {
+            std::vector<std::vector<uint8_t>> in(count, std::vector<uint8_t>(len));
+            std::vector<std::vector<uint8_t>> out(count, std::vector<uint8_t>(400));
+            std::vector<const uint8_t*> in_ptrs;
+            std::vector<uint8_t*> out_ptrs;
+            for (size_t k = 0; k < count; k++) {
+                for (size_t i = 0; i < len; i++) {
+                    in[k][i] = static_cast<uint8_t>(31 * k + 7 * i + len);
+                }
+                in_ptrs.push_back(in[k].data());
+                out_ptrs.push_back(out[k].data());
+            }
+            for (int bits : {128, 256}) {
+                bits == 128 ? protocol::shake128_many(out_ptrs.data(), 400, in_ptrs.data(), len, count)
+                            : protocol::shake256_many(out_ptrs.data(), 400, in_ptrs.data(), len, count);
+                for (size_t k = 0; k < count; k++) {
+                    uint8_t expected[400];
+                    bits == 128 ? protocol::shake128(expected, sizeof(expected), in[k].data(), len)
+                                : protocol::shake256(expected, sizeof(expected), in[k].data(), len);
+                    assert(std::memcmp(expected, out[k].data(), sizeof(expected)) == 0 &&
+                           "Multi-buffer SHAKE mismatch");
+                }
+            }
+        }
+    }
+
+    // Split absorbs and squeezes, as an incremental Shake would see them
+    const uint8_t prefix[5] = {1, 2, 3, 4, 5};
+    uint8_t a[200], b[200];
+    const uint8_t* in[2] = {a, b};
+    for (int i = 0; i < 200; i++) {
+        a[i] = static_cast<uint8_t>(i);
+        b[i] = static_cast<uint8_t>(3 * i + 1);
+    }
+    protocol::ShakeMany many(256, 2);
+    many.absorb_shared(prefix, sizeof(prefix));
+    many.absorb(in, 150);
+    const uint8_t* tail[2] = {a + 150, b + 150};
+    many.absorb(tail, 50);
+    uint8_t out_a[170], out_b[170];
+    uint8_t* outs[2] = {out_a, out_b};
+    many.squeeze(outs, 3);
+    uint8_t* rest[2] = {out_a + 3, out_b + 3};
+    many.squeeze(rest, 167);
+    for (int k = 0; k < 2; k++) {
+        protocol::Shake xof(256);
+        xof.absorb(prefix, sizeof(prefix));
+        xof.absorb(in[k], 200);
+        uint8_t expected[170];
+        xof.squeeze(expected, sizeof(expected));
+        assert(std::memcmp(expected, outs[k], sizeof(expected)) == 0 && "Incremental multi-buffer mismatch");
+    }
+
+    std::cout << "✓ Multi-buffer Keccak test passed\n";
+}
+
+// Batched derivation and seeded expansion agree with their one-at-a-time forms
+void test_batched_hashing() {
+    std::cout << "\nTest: Batched Challenges and Matrix Expansion\n";
+
+    const int length = 256, weight = 60;
+    std::vector<std::array<uint8_t, 32>> seeds(11);
+    std::vector<const uint8_t*> ptrs;
+    for (size_t k = 0; k < seeds.size(); k++) {
+        seeds[k].fill(static_cast<uint8_t>(k));
+        ptrs.push_back(seeds[k].data());
+    }
+    auto batch = protocol::derive_sparse_challenges(ptrs.data(), 32, ptrs.size(), length, weight);
+    assert(batch.size() == seeds.size());
+    for (size_t k = 0; k < seeds.size(); k++) {
+        auto single = protocol::derive_sparse_challenge(seeds[k].data(), 32, length, weight);
+        assert(batch[k].index == single.index && batch[k].sign == single.sign &&
+               "Batched challenge differs from single derivation");
+    }
+    protocol::ChallengeKey key;
+    key.fill(0xa5);
+    auto keyed = protocol::derive_sparse_challenges(&key, ptrs.data(), 32, ptrs.size(), length, weight);
+    for (size_t k = 0; k < seeds.size(); k++) {
+        auto single = protocol::derive_sparse_challenge(&key, seeds[k].data(), 32, length, weight);
+        assert(keyed[k].index == single.index && keyed[k].sign == single.sign &&
+               "Batched keyed challenge differs from single derivation");
+    }
+
+    std::vector<protocol::CompressedCommitment> w1s(5);
+    for (size_t k = 0; k < w1s.size(); k++) {
+        w1s[k].high.assign(40, 1000 + k);
+    }
+    auto digests = protocol::commitment_digests(w1s);
+    for (size_t k = 0; k < w1s.size(); k++) {
+        assert(digests[k] == protocol::commitment_digest(w1s[k]) && "Batched digest mismatch");
+    }
+
+    protocol::MatrixSeed seed;
+    seed.fill(42);
+    for (const char* modulus : {"1073741789", "8589934609"}) {
+        NTL::ZZ q = NTL::conv<NTL::ZZ>(modulus);
+        NTL::ZZ_pPush push(q);
+        // Rows do not depend on how many are expanded alongside them
+        NTL::mat_ZZ_p A = protocol::expand_matrix(seed, 11, 20);
+        NTL::mat_ZZ_p B = protocol::expand_matrix(seed, 3, 20);
+        for (long i = 0; i < 3; i++) {
+            for (long j = 0; j < 20; j++) {
+                assert(A[i][j] == B[i][j] && "Matrix expansion depends on the row group");
+            }
+        }
+        protocol::MatrixSeed other = seed;
+        other[0] ^= 1;
+        assert(protocol::expand_matrix(other, 11, 20) != A && "Different seeds gave the same matrix");
+
+        protocol::Parameters params(11, 20, q, 10, 1);
+        protocol::LatticeProof proof(params, seed);
+        assert(proof.getA() == A && "Seeded key does not use the expanded matrix");
+        auto u = proof.commit();
+        auto c = protocol::LatticeProof::generate_challenge(params.m());
+        assert(proof.verify(u, c, proof.respond(c)) && "Seeded key failed to verify");
+    }
+
+    std::cout << "✓ Batched hashing test passed\n";
+}
+
+// Protocol runs with fixed-weight challenges on the native and NTL paths
+void test_sparse_challenges() {
+    std::cout << "\nTest: Sparse Fixed-Weight Challenges\n";
+
+    std::vector<NTL::ZZ> moduli = {
+        NTL::conv<NTL::ZZ>("1073741789"),
+        NTL::conv<NTL::ZZ>("8589934609")  // above 2^32, exercises the NTL path
+    };
+
+    for (const auto& q : moduli) {
+        std::cout << "  Testing q=" << q << "\n";
+        protocol::Parameters params(32, 64, q, 10, 1, 10.0, 1.5, 8);
+        protocol::LatticeProof proof(params);
+
+        for (int i = 0; i < 5; i++) {
+            auto u = proof.commit();
+            auto c = protocol::LatticeProof::generate_sparse_challenge(params.m(), params.challenge_weight());
+            assert(c.weight() == params.challenge_weight());
+            auto z = proof.respond(c);
+            bool valid = proof.verify(u, c, z);
+            assert(valid && "Sparse challenge verification failed");
+
+            // The dense path must accept the same transcript
+            bool dense_valid = proof.verify(u, c.to_dense(), z);
+            assert(dense_valid && "Dense verification of sparse transcript failed");
+        }
+
+        // Fiat-Shamir challenge bound to the key and the commitment
+        auto u = proof.commit();
+        auto c1 = protocol::derive_sparse_challenge(proof.key_digest(), u, params.m(), params.challenge_weight());
+        auto c2 = protocol::derive_sparse_challenge(proof.key_digest(), u, params.m(), params.challenge_weight());
+        assert(c1.index == c2.index && c1.sign == c2.sign && "Derived challenge is not deterministic");
+        protocol::ChallengeKey other_key = proof.key_digest();
+        other_key[0] ^= 1;
+        auto c3 = protocol::derive_sparse_challenge(other_key, u, params.m(), params.challenge_weight());
+        assert((c3.index != c1.index || c3.sign != c1.sign) && "Derived challenge ignores the key");
+        auto z = proof.respond(c1);
+        bool valid = proof.verify(u, c1, z);
+        assert(valid && "Derived challenge verification failed");
+
+        // Tampered response
+        z[0] = (z[0] + 1) % params.q();
+        valid = proof.verify(u, c1, z);
+        assert(!valid && "Tampered sparse response was accepted");
+
+        // Oversized response, rejected without writing to stdout
+        z[0] = params.q() / 2;
+        std::ostringstream captured;
+        std::streambuf* saved = std::cout.rdbuf(captured.rdbuf());
+        valid = proof.verify(u, c1, z);
+        std::cout.rdbuf(saved);
+        assert(!valid && captured.str().empty() && "Over-bound sparse response was not rejected silently");
+    }
+
+    std::cout << "✓ Sparse challenge protocol test passed\n";
+}
+
+void test_sparse_challenge_encoding() {
+    std::cout << "\nTest: Sparse Challenge Encoding\n";
+
+    const int length = 1024;
+    const int weight = 30;
+    auto c = protocol::sample_sparse_challenge(length, weight);
+    auto bytes = protocol::encode_challenge(c);
+    std::cout << "  Encoded " << weight << "-sparse challenge of length " << length
+              << " in " << bytes.size() << " bytes\n";
+    assert(static_cast<long>(bytes.size()) * 8 >= protocol::encoded_challenge_bits(length, weight));
+
+    auto decoded = protocol::decode_challenge(bytes, length, weight);
+    assert(decoded.index == c.index && decoded.sign == c.sign && "Challenge round trip failed");
+
+    // Wrong weight and malformed challenges are rejected
+    protocol::Parameters params(8, 16, NTL::conv<NTL::ZZ>(97), 10, 1, 10.0, 1.5, 4);
+    protocol::LatticeProof proof(params);
+    proof.commit();
+    try {
+        proof.respond(protocol::sample_sparse_challenge(params.m(), 3));
+        assert(false && "Should have thrown exception for wrong weight");
+    } catch (const std::invalid_argument&) {
+        std::cout << "✓ Wrong challenge weight check passed\n";
+    }
+    try {
+        auto bad = protocol::sample_sparse_challenge(params.m(), 4);
+        bad.index[1] = bad.index[0];
+        proof.respond(bad);
+        assert(false && "Should have thrown exception for repeated index");
+    } catch (const std::invalid_argument&) {
+        std::cout << "✓ Repeated challenge index check passed\n";
+    }
+
+    std::cout << "✓ Sparse challenge encoding test passed\n";
+}
+
+void run_challenge_tests() {
+    test_shake();
+    test_multibuffer_keccak();
+    test_batched_hashing();
+    test_sparse_challenges();
+    test_sparse_challenge_encoding();
+}
+
+} // namespace test
@@ -0,0 +1,121 @@
+#include "test_utils.hpp"
+#include <vector>
+
+namespace test {
+
+void test_compressed_commitments() {
+    std::cout << "\nTest: Compressed Commitments\n";
+
+    const NTL::ZZ q = NTL::conv<NTL::ZZ>("1073741789");
+    const int drop_bits = NTL::NumBits(q) / 2;
+    protocol::Parameters params(32, 64, q, 10, 1, 10.0, 1.5, 8, drop_bits);
+    std::cout << params.toString();
+    protocol::LatticeProof proof(params);
+
+    long full_bits = params.n() * NTL::NumBits(q);
+    long compressed_bits = protocol::compressed_commitment_bits(params.n(), q, drop_bits);
+    std::cout << "  Commitment size: " << full_bits << " -> " << compressed_bits << " bits\n";
+    assert(2 * compressed_bits <= full_bits && "Compression should at least halve the commitment");
+
+    // Interactive mode with dense and sparse challenges
+    for (int i = 0; i < 5; i++) {
+        auto w1 = proof.commit_compressed();
+        auto challenge = protocol::LatticeProof::generate_challenge(params.m());
+        auto z = proof.respond(challenge);
+        bool valid = proof.verify(w1, challenge, z);
+        assert(valid && "Compressed commitment verification failed");
+
+        auto sparse = protocol::LatticeProof::generate_sparse_challenge(params.m(), params.challenge_weight());
+        z = proof.respond(sparse);
+        valid = proof.verify(w1, sparse, z);
+        assert(valid && "Compressed commitment with sparse challenge failed");
+    }
+
+    // Tampered high bits and response
+    {
+        auto w1 = proof.commit_compressed();
+        auto challenge = protocol::LatticeProof::generate_challenge(params.m());
+        auto z = proof.respond(challenge);
+        auto tampered = w1;
+        tampered.high[0] ^= 1;
+        bool valid = proof.verify(tampered, challenge, z);
+        assert(!valid && "Tampered compressed commitment was accepted");
+        z[0] = (z[0] + 1) % params.q();
+        valid = proof.verify(w1, challenge, z);
+        assert(!valid && "Tampered response was accepted");
+        std::cout << "✓ Compressed commitment tampering check passed\n";
+    }
+
+    // Wire form: bits(q) - d bits per coefficient
+    {
+        auto w1 = proof.commit_compressed();
+        auto bytes = protocol::encode_commitment(w1, q, drop_bits);
+        assert(static_cast<long>(bytes.size()) == (compressed_bits + 7) / 8);
+        assert(static_cast<long>(bytes.size()) * 8 == compressed_bits
+               && "Encoded commitment is not packed at bits(q) - d bits");
+        auto decoded = protocol::decode_commitment(bytes, params.n(), q, drop_bits);
+        assert(decoded.high == w1.high && "Commitment encoding round trip failed");
+
+        auto challenge = protocol::LatticeProof::generate_challenge(params.m());
+        bool valid = proof.verify(decoded, challenge, proof.respond(challenge));
+        assert(valid && "Decoded commitment failed to verify");
+
+        int rejected = 0;
+        auto short_bytes = bytes;
+        short_bytes.pop_back();
+        try {
+            protocol::decode_commitment(short_bytes, params.n(), q, drop_bits);
+        } catch (const std::invalid_argument&) {
+            rejected++;
+        }
+        // (q - 1) >> 2 is not all ones, so a 28-bit field can exceed it
+        const std::vector<uint8_t> over = {0xFF, 0xFF, 0xFF, 0x0F};
+        try {
+            protocol::decode_commitment(over, 1, q, 2);
+        } catch (const std::invalid_argument&) {
+            rejected++;
+        }
+        auto padded = protocol::encode_commitment(protocol::CompressedCommitment{{0}}, q, 2);
+        padded.back() |= 0x80;
+        try {
+            protocol::decode_commitment(padded, 1, q, 2);
+        } catch (const std::invalid_argument&) {
+            rejected++;
+        }
+        try {
+            protocol::encode_commitment(protocol::CompressedCommitment{{uint64_t(1) << 15}}, q, drop_bits);
+        } catch (const std::invalid_argument&) {
+            rejected++;
+        }
+        assert(rejected == 4 && "Malformed commitment encoding accepted");
+        std::cout << "  Encoded commitment: " << bytes.size() << " bytes\n";
+    }
+
+    // Non-interactive mode
+    for (int i = 0; i < 5; i++) {
+        auto ni = proof.prove();
+        bool valid = proof.verify(ni);
+        assert(valid && "Non-interactive proof verification failed");
+        ni.digest[0] ^= 1;
+        valid = proof.verify(ni);
+        assert(!valid && "Tampered digest was accepted");
+    }
+
+    // Compression must be enabled explicitly
+    protocol::Parameters plain(8, 8, NTL::conv<NTL::ZZ>(97));
+    protocol::LatticeProof plain_proof(plain);
+    try {
+        plain_proof.commit_compressed();
+        assert(false && "Should have thrown exception");
+    } catch (const std::invalid_argument&) {
+        std::cout << "✓ Compression opt-in check passed\n";
+    }
+
+    std::cout << "✓ Compressed commitment test passed\n";
+}
+
+void run_compression_tests() {
+    test_compressed_commitments();
+}
+
+} // namespace test
@@ -0,0 +1,470 @@
+#include "test_utils.hpp"
+#include <cstdio>
+#include <tuple>
+#include <vector>
+
+namespace test {
+
+// Compare the native kernels against the NTL reference product
+void test_native_kernels() {
+    std::cout << "\nTest: Native Matrix-Vector Kernels\n";
+
+    std::vector<std::tuple<int, int, NTL::ZZ>> shapes = {
+        {4, 4, NTL::conv<NTL::ZZ>(97)},
+        {16, 70, NTL::conv<NTL::ZZ>(8191)},
+        {33, 129, NTL::conv<NTL::ZZ>("1073741789")},
+        {64, 64, NTL::conv<NTL::ZZ>("4294967291")}
+    };
+
+    for (const auto& [n, m, q] : shapes) {
+        std::cout << "  Testing n=" << n << ", m=" << m << ", q=" << q << "\n";
+        NTL::ZZ_p::init(q);
+
+        NTL::mat_ZZ_p A;
+        A.SetDims(n, m);
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < m; j++) {
+                A[i][j] = NTL::random_ZZ_p();
+            }
+        }
+        protocol::NativeMatrix A_native = protocol::to_native(A);
+
+        // Ternary kernel
+        NTL::vec_ZZ s = protocol::sample_ternary(m);
+        std::vector<int8_t> s_ternary;
+        bool ternary = protocol::to_ternary(s, s_ternary);
+        assert(ternary && "Sampled secret is not ternary");
+        std::vector<uint32_t> out(n);
+        protocol::ternary_matvec(A_native, protocol::pack_ternary(s_ternary.data(), m), out.data());
+        assert(protocol::from_native(out.data(), n) == protocol::matrix_vector_mod(A, s)
+               && "Ternary kernel disagrees with reference");
+
+        // Small-coefficient kernel, including full-size centered entries
+        for (long bound : {10L, 1000L, NTL::conv<long>(q / 2)}) {
+            NTL::vec_ZZ y = protocol::sample_uniform(m, bound);
+            std::vector<int32_t> y_centered = protocol::to_centered(y, q);
+            protocol::small_matvec(A_native, y_centered.data(), out.data());
+            assert(protocol::from_native(out.data(), n) == protocol::matrix_vector_mod(A, y)
+                   && "Small-coefficient kernel disagrees with reference");
+        }
+
+        // Batched kernel matches one call per vector
+        const long count = 3;
+        std::vector<int32_t> batch;
+        std::vector<NTL::vec_ZZ> ys;
+        for (long b = 0; b < count; b++) {
+            ys.push_back(protocol::sample_uniform(m, 1000));
+            std::vector<int32_t> yb = protocol::to_centered(ys.back(), q);
+            batch.insert(batch.end(), yb.begin(), yb.end());
+        }
+        std::vector<uint32_t> batch_out(count * n);
+        protocol::small_matvec_batch(A_native, batch.data(), count, batch_out.data());
+        for (long b = 0; b < count; b++) {
+            assert(protocol::from_native(batch_out.data() + b * n, n) == protocol::matrix_vector_mod(A, ys[b])
+                   && "Batched kernel disagrees with reference");
+        }
+    }
+
+    std::cout << "✓ Native kernel test passed\n";
+}
+
+// RNS products agree with NTL for moduli beyond the native word size
+void test_rns_backend() {
+    std::cout << "\nTest: RNS Multi-Modulus Backend\n";
+
+    std::vector<NTL::ZZ> moduli = {
+        NTL::conv<NTL::ZZ>("8589934609"),                              // 2^33 + 17
+        NTL::conv<NTL::ZZ>("18446744073709551629"),                    // 2^64 + 13
+        NTL::conv<NTL::ZZ>("170141183460469231731687303715884105727")  // 2^127 - 1
+    };
+
+    for (const auto& q : moduli) {
+        const int n = 24;
+        const int m = 40;
+        const long bound = 100;
+        NTL::ZZ_p::init(q);
+
+        NTL::mat_ZZ_p A;
+        A.SetDims(n, m);
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < m; j++) {
+                A[i][j] = NTL::random_ZZ_p();
+            }
+        }
+        protocol::RnsMatrix A_rns(A, bound);
+        std::cout << "  q has " << NTL::NumBits(q) << " bits: "
+                  << A_rns.channels() << " RNS channels\n";
+
+        NTL::vec_ZZ v = protocol::sample_uniform(m, bound);
+        std::vector<int32_t> v_small;
+        bool small = protocol::to_small_centered(v, q, bound, v_small);
+        assert(small);
+        assert(A_rns.multiply(v_small) == protocol::matrix_vector_mod(A, v)
+               && "RNS product disagrees with reference");
+    }
+
+    // Channels of a large product run in parallel, or serially inside a
+    // worker of an already parallel caller; the result is the same
+    {
+        const NTL::ZZ q = NTL::conv<NTL::ZZ>("18446744073709551629");
+        NTL::ZZ_p::init(q);
+        NTL::mat_ZZ_p A;
+        A.SetDims(512, 512);
+        for (long i = 0; i < 512; i++) {
+            for (long j = 0; j < 512; j++) {
+                A[i][j] = NTL::random_ZZ_p();
+            }
+        }
+        protocol::RnsMatrix A_rns(A, 10);
+        std::vector<int32_t> v(512);
+        for (long j = 0; j < 512; j++) {
+            v[j] = static_cast<int32_t>(j % 21) - 10;
+        }
+        NTL::vec_ZZ_p parallel = A_rns.multiply(v);
+        assert(!protocol::in_serial_kernel_scope());
+        {
+            protocol::SerialKernelScope outer;
+            protocol::SerialKernelScope inner;
+            assert(protocol::in_serial_kernel_scope());
+            assert(A_rns.multiply(v) == parallel && "Serial RNS channels disagree");
+        }
+        assert(!protocol::in_serial_kernel_scope() && "Serial kernel scope leaked");
+    }
+
+    // Full protocol on the RNS path
+    protocol::Parameters params(16, 32, NTL::conv<NTL::ZZ>("18446744073709551629"));
+    protocol::LatticeProof proof(params);
+    auto u = proof.commit();
+    auto challenge = protocol::LatticeProof::generate_challenge(params.m());
+    auto z = proof.respond(challenge);
+    bool valid = proof.verify(u, challenge, z);
+    assert(valid && "RNS-backed verification failed");
+    z[1] = (z[1] + 1) % params.q();
+    valid = proof.verify(u, challenge, z);
+    assert(!valid && "RNS-backed verification accepted a tampered response");
+
+    std::cout << "✓ RNS backend test passed\n";
+}
+
+// Every tunable kernel matches the reference, and tuned plans round-trip
+// through the cache file
+void test_kernel_autotuner() {
+    std::cout << "\nTest: Kernel Autotuner\n";
+
+    for (const auto& q : {NTL::conv<NTL::ZZ>("1073741789"), NTL::conv<NTL::ZZ>("4294967291")}) {
+        const long n = 37;
+        const long m = 150;
+        NTL::ZZ_p::init(q);
+        NTL::mat_ZZ_p A;
+        A.SetDims(n, m);
+        for (long i = 0; i < n; i++) {
+            for (long j = 0; j < m; j++) {
+                A[i][j] = NTL::random_ZZ_p();
+            }
+        }
+        protocol::NativeMatrix A_native = protocol::to_native(A);
+
+        const long count = 3;
+        std::vector<NTL::vec_ZZ> ys;
+        std::vector<int32_t> v;
+        for (long b = 0; b < count; b++) {
+            ys.push_back(protocol::sample_uniform(m, 1 << 20));
+            std::vector<int32_t> yb = protocol::to_centered(ys.back(), q);
+            v.insert(v.end(), yb.begin(), yb.end());
+        }
+
+        std::vector<protocol::KernelPlan> plans(6);
+        plans[1].kernel = protocol::MatvecKernel::Blocked;
+        plans[2].kernel = protocol::MatvecKernel::Avx2;
+        plans[3].kernel = protocol::MatvecKernel::Threaded;
+        plans[3].threads = 3;
+        plans[4].kernel = protocol::MatvecKernel::Threaded;
+        plans[4].threads = 64;  // more threads than rows
+        plans[5].kernel = protocol::MatvecKernel::Fma;  // inexact here, so the integer path
+        for (const auto& plan : plans) {
+            if ((plan.kernel == protocol::MatvecKernel::Avx2 || plan.kernel == protocol::MatvecKernel::Fma) &&
+                !protocol::kernel_available(plan.kernel, A_native.q)) {
+                continue;
+            }
+            std::vector<uint32_t> out(count * n);
+            protocol::plan_matvec(plan, A_native, v.data(), count, out.data());
+            for (long b = 0; b < count; b++) {
+                assert(protocol::from_native(out.data() + b * n, n) == protocol::matrix_vector_mod(A, ys[b])
+                       && "Tunable kernel disagrees with reference");
+            }
+        }
+    }
+    std::cout << "✓ Kernel variants agree\n";
+
+    // Tune at first use into a scratch cache, then reload from the file
+    const std::string path = "kernel_plans_test.tsv";
+    std::remove(path.c_str());
+    protocol::set_autotune(protocol::AutotuneMode::Tune, path);
+    const NTL::ZZ q = NTL::conv<NTL::ZZ>("1073741789");
+    protocol::KernelPlan tuned = protocol::kernel_plan(64, 128, q);
+
+    protocol::KernelPlanCache cache;
+    bool loaded = cache.load(path);
+    assert(loaded && cache.size() == 1 && "Tuned plan was not cached");
+    protocol::KernelPlan cached;
+    bool found = cache.lookup(protocol::cpu_model(), 64, 128, NTL::NumBits(q), cached);
+    assert(found && cached == tuned && "Cached plan differs from the tuned one");
+    std::cout << "  Tuned plan: " << protocol::kernel_name(tuned.kernel)
+              << ", batch " << tuned.batch << "\n";
+
+    protocol::set_autotune(protocol::AutotuneMode::Cached, path);
+    assert(protocol::kernel_plan(64, 128, q) == tuned && "Cached plan was not used");
+
+    // Tuning draws from its own generator, so keys stay a function of the seed
+    NTL::SetSeed(NTL::conv<NTL::ZZ>(7));
+    protocol::tune_kernels(16, 32, q);
+    const NTL::ZZ after_tuning = NTL::RandomBnd(q);
+    NTL::SetSeed(NTL::conv<NTL::ZZ>(7));
+    assert(NTL::RandomBnd(q) == after_tuning && "Tuning consumed the NTL random stream");
+
+    // Proofs dispatch through the plan
+    protocol::Parameters params(64, 128, q);
+    protocol::LatticeProof proof(params);
+    auto u = proof.commit();
+    auto challenge = protocol::LatticeProof::generate_challenge(params.m());
+    auto z = proof.respond(challenge);
+    bool valid = proof.verify(u, challenge, z);
+    assert(valid && "Verification failed under a tuned plan");
+
+    protocol::set_autotune(protocol::AutotuneMode::Off);
+    std::remove(path.c_str());
+    std::cout << "✓ Kernel autotuner test passed\n";
+}
+
+// Huge-page backing and per-node replicas leave results unchanged
+void test_matrix_placement() {
+    std::cout << "\nTest: Matrix Placement\n";
+    const protocol::MatrixPlacement saved = protocol::matrix_placement();
+    protocol::MatrixPlacement placement;
+    placement.huge_pages = true;
+    placement.numa_replicas = true;
+    protocol::set_matrix_placement(placement);
+
+    // Large blocks are 2 MB aligned; small ones come from the heap
+    {
+        std::vector<uint32_t, protocol::PageAllocator<uint32_t>> big(3 * protocol::kLargePageBytes / 4 + 5, 7);
+        assert(reinterpret_cast<uintptr_t>(big.data()) % protocol::kLargePageBytes == 0);
+        assert(big.back() == 7);
+        std::vector<uint32_t, protocol::PageAllocator<uint32_t>> small(100, 3);
+        assert(small[99] == 3);
+    }
+
+    const auto& topology = protocol::numa_topology();
+    assert(topology.nodes() >= 1);
+    assert(protocol::current_numa_node() < topology.nodes());
+    std::cout << "  " << topology.nodes() << " NUMA node(s)\n";
+
+    // Replication over a fabricated two-node layout
+    const NTL::ZZ q = NTL::conv<NTL::ZZ>("1073741789");
+    NTL::ZZ_p::init(q);
+    NTL::mat_ZZ_p A;
+    A.SetDims(8, 16);
+    for (long i = 0; i < 8; i++) {
+        for (long j = 0; j < 16; j++) {
+            A[i][j] = NTL::random_ZZ_p();
+        }
+    }
+    protocol::NativeMatrix native = protocol::to_native(A);
+    protocol::NumaTopology two_nodes;
+    two_nodes.node_cpus = {{0}, {0}};
+    auto replicas = protocol::replicate_per_node(native, two_nodes);
+    assert(replicas.size() == 2);
+    for (const auto& r : replicas) {
+        assert(r.rows == native.rows && r.cols == native.cols && r.q == native.q && r.data == native.data);
+    }
+    auto panel_replicas = protocol::replicate_panels_per_node(native, two_nodes);
+    const protocol::PanelMatrix panels = protocol::to_panels(native);
+    assert(panel_replicas.size() == 2);
+    for (const auto& r : panel_replicas) {
+        assert(r.rows == panels.rows && r.cols == panels.cols && r.q == panels.q && r.data == panels.data);
+    }
+    protocol::NumaTopology one_node;
+    one_node.node_cpus = {{0}};
+    assert(protocol::replicate_per_node(native, one_node).empty());
+    assert(protocol::replicate_panels_per_node(native, one_node).empty());
+
+    // Proofs under the placement options, at a size that crosses the large-block threshold
+    protocol::Parameters params(768, 768, q);
+    protocol::LatticeProof proof(params);
+    auto u = proof.commit();
+    auto challenge = protocol::LatticeProof::generate_challenge(params.m());
+    auto z = proof.respond(challenge);
+    bool valid = proof.verify(u, challenge, z);
+    assert(valid && "Verification failed with huge pages and replicas enabled");
+
+    protocol::set_matrix_placement(saved);
+    std::cout << "✓ Matrix placement test passed\n";
+}
+
+// Folding reducers agree with division, and the folded AVX2 kernel with the
+// scalar one, for the special moduli Parameters detects
+void test_special_reduction() {
+    std::cout << "\nTest: Pseudo-Mersenne and Solinas Reduction\n";
+
+    const NTL::ZZ solinas = protocol::Parameters::special_prime(32, protocol::ModulusForm::Solinas);
+    assert(protocol::Parameters::special_prime(32) == NTL::conv<NTL::ZZ>("4294967291"));
+    assert(protocol::Parameters::special_prime(30) == NTL::conv<NTL::ZZ>("1073741789"));
+    assert(protocol::Parameters::HighSecurityParams().modulus_form() == protocol::ModulusForm::PseudoMersenne);
+    assert(protocol::Parameters::DefaultParams().modulus_form() == protocol::ModulusForm::Solinas);  // 2^7 - 2^5 + 1
+    std::cout << "  32-bit Solinas prime: " << solinas << "\n";
+
+    const std::vector<std::pair<uint32_t, protocol::ModulusForm>> moduli = {
+        {101, protocol::ModulusForm::Generic},
+        {2147483629, protocol::ModulusForm::PseudoMersenne},
+        {3000000019u, protocol::ModulusForm::Generic},
+        {8191, protocol::ModulusForm::PseudoMersenne},
+        {1073741789, protocol::ModulusForm::PseudoMersenne},
+        {4294967291u, protocol::ModulusForm::PseudoMersenne},
+        {static_cast<uint32_t>(NTL::conv<long>(solinas)), protocol::ModulusForm::Solinas}
+    };
+    for (const auto& [q, form] : moduli) {
+        protocol::Reducer r(q);
+        assert(r.form() == form && "Modulus misclassified");
+        std::vector<uint64_t> xs = {0, 1, q - 1ull, q, 2ull * q, uint64_t(q) * q - 1,
+                                    ~0ull, 1ull << 63};
+        for (int k = 0; k < 1000; k++) {
+            xs.push_back((uint64_t(NTL::RandomWord()) << 32) ^ NTL::RandomWord());
+        }
+        for (uint64_t x : xs) {
+            assert(r.reduce(x) == x % q && "Reducer disagrees with division");
+            const int64_t sx = static_cast<int64_t>(x);
+            const int64_t expected = sx % static_cast<int64_t>(q);
+            assert(r.reduce_signed(sx) == (expected < 0 ? expected + q : expected)
+                   && "Signed reduction disagrees with division");
+        }
+
+        // Folded AVX2 kernel (q >= 2^31) against the scalar kernel
+        if (!protocol::kernel_available(protocol::MatvecKernel::Avx2, q)) {
+            continue;
+        }
+        protocol::NativeMatrix M;
+        M.rows = 9;
+        M.cols = 203;
+        M.q = q;
+        M.data.resize(M.rows * M.cols);
+        for (auto& a : M.data) {
+            a = static_cast<uint32_t>(NTL::RandomBnd(static_cast<long>(q)));
+        }
+        for (long bound : {10L, static_cast<long>(q / 2)}) {
+            std::vector<int32_t> v(2 * M.cols);
+            for (auto& x : v) {
+                x = static_cast<int32_t>(NTL::RandomBnd(2 * bound + 1) - bound);
+            }
+            std::vector<uint32_t> expected(2 * M.rows), actual(2 * M.rows);
+            protocol::small_matvec_batch(M, v.data(), 2, expected.data());
+            protocol::small_matvec_avx2(M, v.data(), 2, actual.data());
+            assert(actual == expected && "AVX2 kernel disagrees with scalar kernel");
+        }
+    }
+
+    // Protocol round trip on an opted-in Solinas modulus
+    protocol::Parameters params = protocol::Parameters::SpecialModulusParams(
+        32, 64, 32, protocol::ModulusForm::Solinas);
+    assert(params.q() == solinas && params.modulus_form() == protocol::ModulusForm::Solinas);
+    protocol::LatticeProof proof(params);
+    auto u = proof.commit();
+    auto c = protocol::LatticeProof::generate_challenge(params.m());
+    assert(proof.verify(u, c, proof.respond(c)) && "Honest transcript rejected with a Solinas modulus");
+
+    try {
+        protocol::Parameters::special_prime(2);
+        assert(false && "Special prime search accepted 2 bits");
+    } catch (const std::invalid_argument&) {
+    }
+    std::cout << "✓ Special reduction test passed\n";
+}
+
+// The double-precision GEMM kernel is exact: one reduction per output when
+// rows fit below 2^53, intermediate reductions when only a few terms do
+void test_fma_kernel() {
+    std::cout << "\nTest: Double-Precision FMA Kernel\n";
+
+    for (uint32_t q : {1073741789u, 4294967291u}) {
+        protocol::NativeMatrix M;
+        M.rows = 37;
+        M.cols = 600;
+        M.q = q;
+        M.data.resize(M.rows * M.cols);
+        for (auto& a : M.data) {
+            a = static_cast<uint32_t>(NTL::RandomBnd(static_cast<long>(q)));
+        }
+        const protocol::PanelMatrix P = protocol::to_panels(M);
+
+        for (long bound : {10L, 1L << 20}) {
+            std::cout << "  Testing q=" << q << ", |v| <= " << bound << " ("
+                      << protocol::fma_exact_terms(q, bound) << " exact terms)\n";
+            for (long count : {1L, 3L, 5L}) {
+                std::vector<int32_t> v(count * M.cols);
+                for (auto& x : v) {
+                    x = static_cast<int32_t>(NTL::RandomBnd(2 * bound + 1) - bound);
+                }
+                std::vector<uint32_t> expected(count * M.rows), actual(count * M.rows);
+                protocol::small_matvec_batch(M, v.data(), count, expected.data());
+                protocol::fma_matvec(P, v.data(), count, actual.data());
+                assert(actual == expected && "FMA kernel disagrees with integer kernel");
+            }
+        }
+    }
+
+    // Products that cannot be exact are refused
+    assert(protocol::fma_exact_terms(4294967291u, 1L << 31) == 0);
+    protocol::NativeMatrix M;
+    M.rows = 1;
+    M.cols = 1;
+    M.q = 4294967291u;
+    M.data = {4000000000u};
+    const int32_t big = 1 << 30;
+    uint32_t out = 0;
+    try {
+        protocol::fma_matvec(protocol::to_panels(M), &big, 1, &out);
+        assert(false && "FMA kernel accepted an inexact product");
+    } catch (const std::invalid_argument&) {
+    }
+
+    // Proofs under a cached Fma plan, which holds the panels only when the
+    // parameters bound every product
+    if (protocol::kernel_available(protocol::MatvecKernel::Fma, 0)) {
+        const std::string path = "kernel_plans_fma_test.tsv";
+        const NTL::ZZ q = NTL::conv<NTL::ZZ>("4294967291");
+        protocol::KernelPlan plan;
+        plan.kernel = protocol::MatvecKernel::Fma;
+        protocol::KernelPlanCache cache;
+        cache.store(protocol::cpu_model(), 64, 256, NTL::NumBits(q), plan);
+        bool saved = cache.save(path);
+        assert(saved);
+        protocol::set_autotune(protocol::AutotuneMode::Cached, path);
+
+        protocol::Parameters params(64, 256, q, 10, 1, 10.0, 1.5, 8, 15);
+        protocol::LatticeProof proof(params);
+        assert(proof.footprint().kernels >= params.n() * params.m() * (sizeof(uint32_t) + sizeof(double))
+               && "Fma plan did not build panels");
+        for (int round = 0; round < 5; round++) {
+            auto u = proof.commit();
+            auto challenge = protocol::LatticeProof::generate_challenge(params.m());
+            auto z = proof.respond(challenge);
+            assert(proof.verify(u, challenge, z) && "Verification failed under the Fma plan");
+        }
+        auto ni = proof.prove();
+        assert(proof.verify(ni) && "Non-interactive proof failed under the Fma plan");
+
+        protocol::set_autotune(protocol::AutotuneMode::Off);
+        std::remove(path.c_str());
+    }
+    std::cout << "✓ FMA kernel test passed\n";
+}
+
+void run_kernel_tests() {
+    test_native_kernels();
+    test_special_reduction();
+    test_fma_kernel();
+    test_matrix_placement();
+    test_kernel_autotuner();
+    test_rns_backend();
+}
+
+} // namespace test
@@ -2,7 +2,19 @@
 
 namespace test {
     void run_basic_tests();
+    void run_archive_tests();
+    void run_batch_tests();
+    void run_challenge_tests();
+    void run_compression_tests();
+    void run_kernel_tests();
+    void run_memory_tests();
     void run_performance_tests();
+    void run_rejection_tests();
+    void run_response_codec_tests();
+    void run_ring_tests();
+    void run_streaming_tests();
+    void run_verify_cache_tests();
+    void run_workspace_tests();
 }
 
 int main() {
@@ -12,6 +24,18 @@ int main() {
         
         // Run all tests
         test::run_basic_tests();
+        test::run_challenge_tests();
+        test::run_compression_tests();
+        test::run_rejection_tests();
+        test::run_archive_tests();
+        test::run_batch_tests();
+        test::run_ring_tests();
+        test::run_streaming_tests();
+        test::run_verify_cache_tests();
+        test::run_response_codec_tests();
+        test::run_workspace_tests();
+        test::run_kernel_tests();
+        test::run_memory_tests();
         test::run_performance_tests();
         
         std::cout << "\nAll tests completed successfully!\n";
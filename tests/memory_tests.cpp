@@ -0,0 +1,80 @@
+#include "test_utils.hpp"
+#include <vector>
+
+namespace test {
+
+void test_memory_footprint() {
+    std::cout << "\nTest: Memory Footprint\n";
+
+    protocol::Parameters params(64, 96, NTL::conv<NTL::ZZ>("1073741789"));
+    protocol::LatticeProof proof(params);
+    auto f = proof.footprint();
+
+    // NTL's per-entry blocks dwarf the raw 4 bytes per entry of A
+    const size_t raw = static_cast<size_t>(params.n()) * params.m() * 4;
+    assert(f.matrix > 4 * raw && "Matrix footprint is implausibly small");
+    assert(f.kernels == raw && "Native copy of A should be exactly the raw entries");
+    assert(f.public_key > 0 && f.secret > 0 && f.session == 0);
+    std::cout << "  n=" << params.n() << ", m=" << params.m() << ": " << f.total() << " bytes ("
+              << f.matrix << " in A, " << raw << " raw)\n";
+
+    // Commit state is charged to the session
+    proof.commit();
+    assert(proof.footprint().session > 0 && "Commitment mask not counted");
+
+    // The RNS path keeps residue matrices instead of a native copy
+    protocol::Parameters wide(16, 32, NTL::conv<NTL::ZZ>("8589934609"));
+    protocol::LatticeProof wide_proof(wide);
+    assert(wide_proof.footprint().kernels >= 2 * 16 * 32 * 4 && "RNS channels not counted");
+
+    std::cout << "✓ Memory footprint test passed\n";
+}
+
+void test_allocation_counters() {
+    std::cout << "\nTest: Allocation Counters\n";
+    assert(protocol::alloc_hook_installed() && "Test binary should link the allocation hook");
+
+    protocol::Parameters params(32, 64, NTL::conv<NTL::ZZ>("1073741789"));
+    auto setup = protocol::alloc_counters(protocol::AllocPhase::Setup);
+    protocol::LatticeProof proof(params);
+    auto setup_delta = protocol::alloc_counters(protocol::AllocPhase::Setup) - setup;
+    assert(setup_delta.allocations > 0 && setup_delta.bytes_allocated > 0);
+
+    auto commit = protocol::alloc_counters(protocol::AllocPhase::Commit);
+    auto verify = protocol::alloc_counters(protocol::AllocPhase::Verify);
+    auto u = proof.commit();
+    auto challenge = protocol::LatticeProof::generate_challenge(params.m());
+    auto z = proof.respond(challenge);
+    bool valid = proof.verify(u, challenge, z);
+    assert(valid);
+    auto commit_delta = protocol::alloc_counters(protocol::AllocPhase::Commit) - commit;
+    auto verify_delta = protocol::alloc_counters(protocol::AllocPhase::Verify) - verify;
+    assert(commit_delta.allocations > 0 && verify_delta.allocations > 0);
+    std::cout << "  Setup " << setup_delta.allocations << ", commit " << commit_delta.allocations
+              << ", verify " << verify_delta.allocations << " allocations\n";
+
+    // Scopes nest and restore the enclosing phase
+    auto other = protocol::alloc_counters(protocol::AllocPhase::Other);
+    {
+        protocol::AllocPhaseScope outer(protocol::AllocPhase::Verify);
+        {
+            protocol::AllocPhaseScope inner(protocol::AllocPhase::Commit);
+        }
+        std::vector<int> scratch(1000);
+        (void)scratch;
+    }
+    auto before_verify = protocol::alloc_counters(protocol::AllocPhase::Verify);
+    std::vector<int> untagged(1000);
+    (void)untagged;
+    assert(protocol::alloc_counters(protocol::AllocPhase::Verify).allocations == before_verify.allocations);
+    assert(protocol::alloc_counters(protocol::AllocPhase::Other).allocations > other.allocations);
+
+    std::cout << "✓ Allocation counter test passed\n";
+}
+
+void run_memory_tests() {
+    test_memory_footprint();
+    test_allocation_counters();
+}
+
+} // namespace test
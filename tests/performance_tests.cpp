@@ -1,4 +1,5 @@
 #include "test_utils.hpp"
+#include "protocol/response_codec.hpp"
 #include <vector>
 #include <tuple>
 
@@ -29,21 +30,31 @@ ProofSize calculate_proof_size(const protocol::Parameters& params,
     return size;
 }
 
+// Allocations charged to phase since the snapshot before
+PhaseAllocations allocations_since(protocol::AllocPhase phase, const protocol::AllocCounters& before) {
+    protocol::AllocCounters delta = protocol::alloc_counters(phase) - before;
+    return {delta.allocations, delta.bytes_allocated};
+}
+
 // Implementation of benchmark_protocol
 BenchmarkResult benchmark_protocol(const protocol::Parameters& params) {
     BenchmarkResult result;
     auto start_total = Clock::now();
     
     // Setup
+    auto allocs = protocol::alloc_counters(protocol::AllocPhase::Setup);
     auto start = Clock::now();
     protocol::LatticeProof proof(params);
     auto end = Clock::now();
+    result.setup_allocs = allocations_since(protocol::AllocPhase::Setup, allocs);
     result.setup_time = std::chrono::duration_cast<Nanoseconds>(end - start);
     
     // Commit
+    allocs = protocol::alloc_counters(protocol::AllocPhase::Commit);
     start = Clock::now();
     auto u = proof.commit();
     end = Clock::now();
+    result.commit_allocs = allocations_since(protocol::AllocPhase::Commit, allocs);
     result.commit_time = std::chrono::duration_cast<Nanoseconds>(end - start);
     
     // Challenge
@@ -53,15 +64,19 @@ BenchmarkResult benchmark_protocol(const protocol::Parameters& params) {
     result.challenge_time = std::chrono::duration_cast<Nanoseconds>(end - start);
     
     // Response
+    allocs = protocol::alloc_counters(protocol::AllocPhase::Respond);
     start = Clock::now();
     auto z = proof.respond(challenge);
     end = Clock::now();
+    result.response_allocs = allocations_since(protocol::AllocPhase::Respond, allocs);
     result.response_time = std::chrono::duration_cast<Nanoseconds>(end - start);
     
     // Verify
+    allocs = protocol::alloc_counters(protocol::AllocPhase::Verify);
     start = Clock::now();
     bool valid = proof.verify(u, challenge, z);
     end = Clock::now();
+    result.verify_allocs = allocations_since(protocol::AllocPhase::Verify, allocs);
     result.verify_time = std::chrono::duration_cast<Nanoseconds>(end - start);
     
     assert(valid && "Benchmark proof verification failed");
@@ -71,10 +86,52 @@ BenchmarkResult benchmark_protocol(const protocol::Parameters& params) {
     
     // Calculate proof sizes
     result.proof_size = calculate_proof_size(params, u, challenge, z);
+    result.footprint = proof.footprint();
     
     return result;
 }
 
+// Entropy-coded responses: size against fixed-width residues and the paper's
+// n log(2 sigma sqrt(n)) bits, and decode throughput of both decoders
+void benchmark_response_codec(const protocol::Parameters& params, size_t theoretical_bits) {
+    protocol::LatticeProof proof(params);
+    protocol::ResponseCodec codec(params);
+    const int responses = 32;
+    std::vector<std::vector<uint8_t>> coded;
+    size_t bytes = 0;
+    for (int r = 0; r < responses; r++) {
+        proof.commit();
+        coded.push_back(codec.encode(proof.respond(protocol::LatticeProof::generate_challenge(params.m()))));
+        bytes += coded.back().size();
+    }
+
+    std::vector<int32_t> z(params.m());
+    auto throughput = [&](bool vectorized) {
+        const int passes = 20;
+        auto start = Clock::now();
+        for (int pass = 0; pass < passes; pass++) {
+            for (const auto& c : coded) {
+                if (vectorized) {
+                    codec.decode(c.data(), c.size(), z);
+                } else {
+                    codec.decode_scalar(c.data(), c.size(), z);
+                }
+            }
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return passes * responses * params.m() / seconds / 1e6;
+    };
+    const double scalar_rate = throughput(false);
+    const double vector_rate = throughput(true);
+
+    const double average_bits = 8.0 * bytes / responses;
+    std::cout << "Entropy-coded response: " << average_bits << " bits"
+              << " (model entropy " << codec.entropy_bits() << ", fixed width "
+              << params.m() * NTL::NumBits(params.q()) << ", theoretical " << theoretical_bits << ")\n"
+              << "  Decode: " << vector_rate << " M coefficients/s"
+              << " (scalar " << scalar_rate << ")\n";
+}
+
 void run_performance_tests() {
     std::cout << "\nRunning Performance Tests with Real-World Parameters\n";
     
@@ -123,6 +180,8 @@ void run_performance_tests() {
             std::cout << "Theoretical size (as per paper): " 
                      << theoretical_size << " bits ("
                      << (theoretical_size / 8.0 / 1024.0) << " KB)\n";
+
+            benchmark_response_codec(params, size * static_cast<size_t>(std::ceil(log_response)));
                      
         } catch (const std::exception& e) {
             std::cerr << "Error with " << label << " parameters: " << e.what() << "\n";
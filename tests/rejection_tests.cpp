@@ -0,0 +1,119 @@
+#include "test_utils.hpp"
+#include <cmath>
+#include <vector>
+
+namespace test {
+
+// Released responses stay inside the rejection bound on challenged coordinates
+static void check_bounded(const protocol::Parameters& params, const NTL::vec_ZZ& c, const NTL::vec_ZZ& z) {
+    for (int j = 0; j < params.m(); j++) {
+        NTL::ZZ zj = z[j] > params.q() / 2 ? z[j] - params.q() : z[j];
+        if (c[j] != 0) {
+            assert(NTL::abs(zj) <= params.rejection_bound() && "Released z outside the rejection bound");
+        }
+    }
+}
+
+void test_rejection_parameters() {
+    std::cout << "\nTest: Rejection Sampling Parameters\n";
+
+    for (double reps : {1.5, 3.0, 10.0}) {
+        int y = protocol::Parameters::rejection_y_range(256, 1, reps);
+        auto params = protocol::Parameters::RejectionSamplingParams(16, 256, NTL::conv<NTL::ZZ>("1073741789"), reps);
+        assert(params.y_range() == y);
+        assert(params.expected_repetitions() <= reps && "Chosen y_range misses the repetition target");
+        // y_range is the smallest that meets the target
+        protocol::Parameters smaller(16, 256, params.q(), y - 1, 1);
+        assert(smaller.expected_repetitions() > reps && "rejection_y_range is not minimal");
+        std::cout << "  " << reps << " repetitions -> y_range " << y
+                  << " (expected " << params.expected_repetitions() << ")\n";
+    }
+
+    try {
+        protocol::Parameters too_narrow(16, 256, NTL::conv<NTL::ZZ>("1073741789"), 10, 1, 10.0, 1.5, 0, 0, 2.0);
+        assert(false && "Should have thrown exception");
+    } catch (const std::invalid_argument&) {
+        std::cout << "✓ Repetition target validation passed\n";
+    }
+
+    // The target survives a parameter block round trip
+    auto params = protocol::Parameters::RejectionSamplingParams(8, 64, NTL::conv<NTL::ZZ>(8191), 2.0, 16);
+    protocol::ByteWriter out;
+    protocol::write_parameters(out, params);
+    protocol::ByteReader in(out.bytes().data(), out.bytes().size());
+    assert(protocol::read_parameters(in) == params && "Parameter round trip lost rejection settings");
+
+    std::cout << "✓ Rejection sampling parameter test passed\n";
+}
+
+void test_rejection_sampling() {
+    std::cout << "\nTest: Rejection-Sampled Responses\n";
+
+    const NTL::ZZ q = NTL::conv<NTL::ZZ>("1073741789");
+    auto params = protocol::Parameters::RejectionSamplingParams(32, 128, q, 3.0);
+    protocol::LatticeProof proof(params);
+
+    // Interactive: abort and recommit until a response is released
+    const int rounds = 200;
+    for (int i = 0; i < rounds; i++) {
+        auto challenge = protocol::LatticeProof::generate_challenge(params.m());
+        NTL::vec_ZZ z;
+        NTL::vec_ZZ_p u;
+        do {
+            u = proof.commit();
+        } while (!proof.try_respond(challenge, z));
+        check_bounded(params, challenge, z);
+        bool valid = proof.verify(u, challenge, z);
+        assert(valid && "Rejection-sampled response failed verification");
+    }
+
+    const auto& stats = proof.rejection_stats();
+    std::cout << "  Interactive: " << stats.attempts << " attempts for " << stats.accepted
+              << " responses, abort rate " << stats.abort_rate() << "\n";
+    assert(stats.accepted == static_cast<uint64_t>(rounds));
+    assert(stats.attempts >= stats.accepted);
+    // Dense challenges test about 2m/3 coordinates, so the bound is generous
+    assert(stats.attempts < 3 * params.expected_repetitions() * rounds && "Abort rate far above target");
+
+    // A spent mask cannot be answered again
+    proof.commit();
+    NTL::vec_ZZ z;
+    proof.try_respond(protocol::LatticeProof::generate_challenge(params.m()), z);
+    try {
+        proof.respond(protocol::LatticeProof::generate_challenge(params.m()));
+        assert(false && "Should have thrown exception");
+    } catch (const std::logic_error&) {
+        std::cout << "✓ Mask reuse check passed\n";
+    }
+
+    // Non-interactive proofs retry internally over batched candidate masks
+    auto ni_params = protocol::Parameters(32, 128, q,
+        protocol::Parameters::rejection_y_range(16, 1, 4.0), 1, 10.0, 1.5, 16, 10, 4.0);
+    protocol::LatticeProof ni_proof(ni_params);
+    for (int i = 0; i < 50; i++) {
+        auto ni = ni_proof.prove();
+        bool valid = ni_proof.verify(ni);
+        assert(valid && "Rejection-sampled non-interactive proof failed verification");
+        auto c = protocol::derive_sparse_challenge(&ni_proof.key_digest(), ni.digest.data(), ni.digest.size(),
+                                                   ni_params.m(), ni_params.challenge_weight());
+        check_bounded(ni_params, c.to_dense(), ni.z);
+    }
+    const auto& ni_stats = ni_proof.rejection_stats();
+    std::cout << "  Non-interactive: " << ni_stats.attempts << " attempts for " << ni_stats.accepted
+              << " proofs (max " << ni_stats.max_attempts << "), abort rate " << ni_stats.abort_rate()
+              << ", retry time " << ni_stats.retry_seconds << " of " << ni_stats.seconds << " s\n";
+    assert(ni_stats.accepted == 50);
+    assert(ni_stats.retry_seconds <= ni_stats.seconds);
+
+    ni_proof.reset_rejection_stats();
+    assert(ni_proof.rejection_stats().attempts == 0);
+
+    std::cout << "✓ Rejection sampling test passed\n";
+}
+
+void run_rejection_tests() {
+    test_rejection_parameters();
+    test_rejection_sampling();
+}
+
+} // namespace test
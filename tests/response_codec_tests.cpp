@@ -0,0 +1,125 @@
+#include "test_utils.hpp"
+#include "protocol/response_codec.hpp"
+#include <vector>
+
+namespace test {
+
+// Honest responses round-trip, code near the model entropy, and the AVX2 and
+// scalar decoders agree
+void test_response_codec_roundtrip() {
+    std::cout << "\nTest: Response Codec Round Trip\n";
+
+    const NTL::ZZ q = NTL::conv<NTL::ZZ>("1073741789");
+    std::vector<protocol::Parameters> sets = {
+        protocol::Parameters(64, 512, q),
+        protocol::Parameters(64, 509, q, 10, 1, 10.0, 1.5, 32),  // sparse, m not a multiple of 8
+        protocol::Parameters::RejectionSamplingParams(64, 256, q),
+    };
+    for (const protocol::Parameters& params : sets) {
+        protocol::LatticeProof proof(params);
+        protocol::ResponseCodec codec(params);
+        size_t bytes = 0;
+        const int rounds = 20;
+        for (int r = 0; r < rounds; r++) {
+            NTL::vec_ZZ_p u = proof.commit();
+            NTL::vec_ZZ z;
+            NTL::vec_ZZ c;
+            if (params.challenge_weight() > 0) {
+                auto sparse = protocol::LatticeProof::generate_sparse_challenge(params.m(), params.challenge_weight());
+                z = proof.respond(sparse);
+                c = sparse.to_dense();
+            } else {
+                c = protocol::LatticeProof::generate_challenge(params.m());
+                z = proof.respond(c);
+            }
+            std::vector<uint8_t> coded = codec.encode(z);
+            bytes += coded.size();
+
+            // Decoded z is centered, which verify() accepts like the residues
+            NTL::vec_ZZ decoded = codec.decode(coded.data(), coded.size());
+            for (long j = 0; j < params.m(); j++) {
+                assert((decoded[j] - z[j]) % params.q() == 0 && NTL::abs(decoded[j]) <= codec.bound());
+            }
+            assert(proof.verify(u, c, decoded) && "Decoded response rejected");
+
+            std::vector<int32_t> fast(params.m());
+            std::vector<int32_t> slow(params.m());
+            codec.decode(coded.data(), coded.size(), fast);
+            codec.decode_scalar(coded.data(), coded.size(), slow);
+            assert(fast == slow && "Vectorized and scalar decoders differ");
+            assert(codec.encode(fast) == coded && "Word and NTL encoders differ");
+        }
+        const double average = static_cast<double>(bytes) / rounds;
+        const double entropy = codec.entropy_bits() / 8;
+        std::cout << "  m=" << params.m() << ", y_range=" << params.y_range() << ": "
+                  << average << " bytes per response, entropy " << entropy << ", fixed width "
+                  << params.m() * NTL::NumBits(params.q()) / 8 << "\n";
+        // Rejection sampling trims the tails the model allows for; otherwise
+        // the stream is the entropy plus lane states and quantization loss
+        assert(average < entropy * 1.03 + 4 * protocol::ResponseCodec::kLanes + 8);
+    }
+
+    std::cout << "✓ Response codec round trip test passed\n";
+}
+
+// Arbitrary coefficients escape and survive; damaged streams are rejected
+void test_response_codec_escapes() {
+    std::cout << "\nTest: Response Codec Escapes\n";
+
+    protocol::Parameters params(16, 40, NTL::conv<NTL::ZZ>("1073741789"));
+    protocol::ResponseCodec codec(params);
+    std::vector<int32_t> z(params.m());
+    for (long j = 0; j < params.m(); j++) {
+        z[j] = static_cast<int32_t>((j % 3 == 0 ? 100000 * j : j) * (j % 2 ? -1 : 1));
+    }
+    z[1] = 536870894;  // q/2, the largest centered value
+    std::vector<uint8_t> coded = codec.encode(z);
+    std::vector<int32_t> decoded(params.m());
+    codec.decode(coded.data(), coded.size(), decoded);
+    assert(decoded == z && "Escaped coefficients lost");
+
+    // Residues and other representatives of the same class code the same
+    NTL::vec_ZZ wrapped;
+    wrapped.SetLength(params.m());
+    for (long j = 0; j < params.m(); j++) {
+        wrapped[j] = NTL::ZZ(z[j]) + (j % 2 ? 3 : -2) * params.q();
+    }
+    assert(codec.encode(wrapped) == coded);
+
+    // Wide moduli escape through NTL
+    protocol::Parameters wide(8, 24, NTL::conv<NTL::ZZ>("8589934609"));
+    protocol::ResponseCodec wide_codec(wide);
+    NTL::vec_ZZ big;
+    big.SetLength(wide.m());
+    for (long j = 0; j < wide.m(); j++) {
+        big[j] = j % 2 ? NTL::ZZ(j) : NTL::conv<NTL::ZZ>("-4000000000") + j;
+    }
+    std::vector<uint8_t> wide_coded = wide_codec.encode(big);
+    assert(wide_codec.decode(wide_coded.data(), wide_coded.size()) == big);
+
+    int rejected = 0;
+    for (size_t cut = 0; cut < coded.size(); cut++) {
+        try {
+            codec.decode(coded.data(), cut, decoded);
+        } catch (const std::runtime_error&) {
+            rejected++;
+        }
+    }
+    assert(rejected == static_cast<int>(coded.size()) && "Truncated stream decoded");
+    std::vector<uint8_t> damaged = coded;
+    damaged.back() ^= 0x40;
+    try {
+        codec.decode(damaged.data(), damaged.size(), decoded);
+        assert(false && "Damaged stream decoded");
+    } catch (const std::runtime_error&) {
+    }
+
+    std::cout << "✓ Response codec escape test passed\n";
+}
+
+void run_response_codec_tests() {
+    test_response_codec_roundtrip();
+    test_response_codec_escapes();
+}
+
+} // namespace test
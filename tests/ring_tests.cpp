@@ -0,0 +1,183 @@
+#include "test_utils.hpp"
+#include "protocol/ring.hpp"
+#include <cstring>
+#include <string>
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace test {
+
+std::string ring_name(const char* role) {
+    return std::string("/lattice_zkp_test_") + role + "_" + std::to_string(getpid());
+}
+
+// Varied message sizes through a small ring: wrap-around, a blocked producer,
+// in-place reads and delivery of everything published before close
+void test_ring_transport() {
+    std::cout << "\nTest: Shared-Memory Ring Transport\n";
+
+    const std::string name = ring_name("transport");
+    protocol::ShmRing consumer(name, 4096);
+    const int count = 2000;
+
+    std::thread producer_thread([&] {
+        protocol::ShmRing producer(name);
+        for (int k = 0; k < count; k++) {
+            const size_t len = (k * 37) % 1500;
+            uint8_t* out = producer.begin_write(1 + k % 3, len);
+            for (size_t i = 0; i < len; i++) {
+                out[i] = static_cast<uint8_t>(k + i);
+            }
+            producer.end_write();
+        }
+        producer.close();
+    });
+
+    protocol::RingRecord record;
+    int received = 0;
+    while (consumer.read(record)) {
+        assert(record.type == static_cast<uint32_t>(1 + received % 3) && "Ring message type mismatch");
+        assert(record.size == static_cast<size_t>((received * 37) % 1500) && "Ring message size mismatch");
+        for (size_t i = 0; i < record.size; i++) {
+            assert(record.data[i] == static_cast<uint8_t>(received + i) && "Ring message corrupted");
+        }
+        consumer.release();
+        received++;
+    }
+    producer_thread.join();
+    assert(received == count && "Ring lost messages");
+    std::cout << "  " << received << " messages through a " << consumer.capacity() << "-byte ring\n";
+
+    try {
+        protocol::ShmRing bad(ring_name("bad"), 5000);
+        assert(false && "Ring accepted a capacity that is not a power of two");
+    } catch (const std::invalid_argument&) {
+    }
+    try {
+        consumer.begin_write(1, 4096);
+        assert(false && "Ring accepted a message larger than half its capacity");
+    } catch (const std::invalid_argument&) {
+    }
+
+    std::cout << "✓ Ring transport test passed\n";
+}
+
+// Prover and a forked verifier process exchange u, c, z and the verdict
+void test_ring_protocol() {
+    std::cout << "\nTest: Protocol over Shared-Memory Rings\n";
+
+    protocol::Parameters params(64, 128, NTL::conv<NTL::ZZ>("1073741789"));
+    protocol::LatticeProof proof(params);
+    const std::string to_verifier = ring_name("to_verifier");
+    const std::string to_prover = ring_name("to_prover");
+    protocol::ShmRing out(to_verifier, 1 << 16);
+    protocol::ShmRing in(to_prover, 1 << 16);
+    const int rounds = 50;
+
+    pid_t child = fork();
+    assert(child >= 0);
+    if (child == 0) {
+        // Verifier: a fresh process sharing only the key image from fork
+        int status = 0;
+        try {
+            protocol::ShmRing requests(to_verifier);
+            protocol::ShmRing replies(to_prover);
+            NTL::vec_ZZ_p u;
+            NTL::vec_ZZ z;
+            while (protocol::receive_commitment(requests, u)) {
+                NTL::vec_ZZ c = protocol::LatticeProof::generate_challenge(params.m());
+                protocol::send_challenge(replies, c);
+                if (!protocol::receive_response(requests, z)) break;
+                protocol::send_verdict(replies, proof.verify(u, c, z));
+            }
+        } catch (...) {
+            status = 1;
+        }
+        _exit(status);
+    }
+
+    for (int r = 0; r < rounds; r++) {
+        protocol::send_commitment(out, proof.commit());
+        NTL::vec_ZZ c;
+        bool ok = protocol::receive_challenge(in, c);
+        assert(ok && c.length() == params.m());
+        protocol::send_response(out, proof.respond(c));
+        bool accepted = false;
+        ok = protocol::receive_verdict(in, accepted);
+        assert(ok && accepted && "Verifier rejected an honest transcript over the ring");
+    }
+    out.close();
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0 && "Verifier process failed");
+    std::cout << "  " << rounds << " rounds verified in a separate process\n";
+    std::cout << "✓ Ring protocol test passed\n";
+}
+
+// Record headers written by a hostile peer are rejected before the consumer
+// reads past what was published
+void test_ring_corrupt_headers() {
+    std::cout << "\nTest: Corrupt Ring Headers\n";
+
+    // Overwrites the header of a 16-byte record with (size, type)
+    auto forge = [](protocol::ShmRing& ring, uint32_t size, uint32_t type) {
+        uint8_t* out = ring.begin_write(1, 16);
+        uint32_t fields[2] = {size, type};
+        std::memcpy(out - 8, fields, sizeof(fields));
+        ring.end_write();
+    };
+    const uint32_t forged[][2] = {
+        {0xFFFFFFFFu, 1},  // far past the mapping
+        {17, 1},           // one byte past head
+        {0, 0},            // wrap marker skipping beyond head
+    };
+    int rejected = 0;
+    for (const auto& fields : forged) {
+        const std::string name = ring_name("corrupt");
+        protocol::ShmRing consumer(name, 4096);
+        protocol::ShmRing producer(name);
+        forge(producer, fields[0], fields[1]);
+        protocol::RingRecord record;
+        try {
+            consumer.try_read(record);
+            assert(false && "Corrupt ring header accepted");
+        } catch (const std::runtime_error&) {
+            rejected++;
+        }
+    }
+
+    // Protocol messages must be whole coefficients
+    NTL::ZZ_p::init(NTL::conv<NTL::ZZ>("1073741789"));
+    const std::string name = ring_name("ragged");
+    protocol::ShmRing consumer(name, 4096);
+    protocol::ShmRing producer(name);
+    for (auto type : {protocol::RingMessage::Commitment, protocol::RingMessage::Response}) {
+        std::memset(producer.begin_write(static_cast<uint32_t>(type), 4 * 8 + 1), 0, 4 * 8 + 1);
+        producer.end_write();
+        try {
+            NTL::vec_ZZ_p u;
+            NTL::vec_ZZ z;
+            if (type == protocol::RingMessage::Commitment) {
+                protocol::receive_commitment(consumer, u);
+            } else {
+                protocol::receive_response(consumer, z);
+            }
+            assert(false && "Ragged protocol message accepted");
+        } catch (const std::runtime_error&) {
+            rejected++;
+        }
+    }
+    assert(rejected == 5);
+
+    std::cout << "✓ Corrupt ring header test passed\n";
+}
+
+void run_ring_tests() {
+    test_ring_transport();
+    test_ring_protocol();
+    test_ring_corrupt_headers();
+}
+
+} // namespace test
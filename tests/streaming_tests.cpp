@@ -0,0 +1,106 @@
+#include "test_utils.hpp"
+#include "protocol/streaming.hpp"
+#include <vector>
+
+namespace test {
+
+// Feed z in chunks of the given size
+bool stream_response(protocol::StreamingVerifier& sv, const NTL::vec_ZZ& z, long chunk) {
+    for (long j0 = 0; j0 < z.length(); j0 += chunk) {
+        NTL::vec_ZZ part;
+        part.SetLength(std::min(chunk, z.length() - j0));
+        for (long j = 0; j < part.length(); j++) {
+            part[j] = z[j0 + j];
+        }
+        if (!sv.feed(part)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Chunked verification agrees with verify() on both arithmetic paths
+void test_streaming_verifier() {
+    std::cout << "\nTest: Streaming Verification\n";
+
+    for (const char* modulus : {"1073741789", "8589934609"}) {
+        NTL::ZZ q = NTL::conv<NTL::ZZ>(modulus);
+        protocol::Parameters params(32, 600, q, 10, 1, 10.0, 1.5, 16);
+        protocol::LatticeProof proof(params);
+        protocol::StreamingVerifier sv(proof);
+        std::cout << "  Testing q=" << q << "\n";
+
+        for (long chunk : {1L, 7L, 300L, 600L}) {
+            auto u = proof.commit();
+            auto c = protocol::LatticeProof::generate_challenge(params.m());
+            auto z = proof.respond(c);
+            sv.begin(u, c);
+            stream_response(sv, z, chunk);
+            assert(sv.finish() && proof.verify(u, c, z) && "Streamed honest transcript rejected");
+
+            // Tampered coefficient: passes the norm check, fails the product
+            z[chunk % params.m()] += 1;
+            sv.begin(u, c);
+            stream_response(sv, z, chunk);
+            assert(!sv.finish() && !proof.verify(u, c, z) && "Streamed tampered transcript accepted");
+        }
+
+        // Sparse challenges, and the wire format split mid-coefficient
+        auto u = proof.commit();
+        auto c = protocol::LatticeProof::generate_sparse_challenge(params.m(), params.challenge_weight());
+        auto z = proof.respond(c);
+        const long width = NTL::NumBytes(q);
+        std::vector<uint8_t> bytes(params.m() * width);
+        for (long j = 0; j < params.m(); j++) {
+            NTL::BytesFromZZ(bytes.data() + j * width, z[j] % q, width);
+        }
+        sv.begin(u, c);
+        for (size_t pos = 0; pos < bytes.size(); pos += 3) {
+            sv.feed(bytes.data() + pos, std::min<size_t>(3, bytes.size() - pos));
+        }
+        assert(sv.finish() && "Byte-streamed sparse transcript rejected");
+
+        // Representatives other than the residue count with their full size,
+        // as in verify(): z_j + q may pass, z_j - q and z_j + 2q may not
+        u = proof.commit();
+        auto dense = protocol::LatticeProof::generate_challenge(params.m());
+        z = proof.respond(dense);
+        for (long shift : {1L, -1L, 2L}) {
+            for (long j : {0L, 3L, params.m() - 1L}) {
+                NTL::vec_ZZ shifted = z;
+                shifted[j] += shift * q;
+                sv.begin(u, dense);
+                stream_response(sv, shifted, 7);
+                assert(sv.finish() == proof.verify(u, dense, shifted) &&
+                       "Streamed verdict differs for a shifted coefficient");
+            }
+        }
+
+        // An oversized coefficient ends the transcript where it appears
+        z = proof.respond(protocol::LatticeProof::generate_challenge(params.m()));
+        z[5] = q / 2;
+        sv.begin(u, protocol::LatticeProof::generate_challenge(params.m()));
+        bool open = stream_response(sv, z, 1);
+        assert(!open && sv.rejected() && sv.consumed() == 6 && "Oversized response not rejected early");
+        assert(!sv.finish());
+
+        // A truncated response is malformed, not merely invalid
+        sv.begin(u, c);
+        NTL::vec_ZZ head;
+        head.SetLength(10);
+        sv.feed(head);
+        try {
+            sv.finish();
+            assert(false && "Truncated response was accepted");
+        } catch (const std::invalid_argument&) {
+        }
+    }
+
+    std::cout << "✓ Streaming verification test passed\n";
+}
+
+void run_streaming_tests() {
+    test_streaming_verifier();
+}
+
+} // namespace test
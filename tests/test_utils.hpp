@@ -32,6 +32,12 @@ struct ProofSize {
                   << " (" << kb_size << " KB, " << mb_size << " MB)\n";
     }
 };
+// Heap allocations charged to one protocol phase
+struct PhaseAllocations {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
 // Structure for benchmarking results
 struct BenchmarkResult {
     Nanoseconds setup_time;
@@ -41,6 +47,8 @@ struct BenchmarkResult {
     Nanoseconds verify_time;
     Nanoseconds total_time;
     ProofSize proof_size;
+    protocol::MemoryFootprint footprint;
+    PhaseAllocations setup_allocs, commit_allocs, response_allocs, verify_allocs;
     
     void print() const {
         std::cout << "Time Measurements:\n"
@@ -57,6 +65,21 @@ struct BenchmarkResult {
                   << "  Total time: " << total_time.count() << " ns"
                   << " (" << (total_time.count() / 1e6) << " ms)\n\n";
         proof_size.print();
+        std::cout << "\nMemory:\n"
+                  << "  Footprint: " << footprint.total() / 1024.0 << " KB"
+                  << " (A " << footprint.matrix / 1024.0 << " KB, t " << footprint.public_key / 1024.0
+                  << " KB, s " << footprint.secret / 1024.0 << " KB, session "
+                  << footprint.session / 1024.0 << " KB, kernels " << footprint.kernels / 1024.0 << " KB)\n";
+        if (protocol::alloc_hook_installed()) {
+            auto row = [](const char* label, const PhaseAllocations& a) {
+                std::cout << "  " << label << a.allocations << " allocations, "
+                          << a.bytes / 1024.0 << " KB\n";
+            };
+            row("Setup: ", setup_allocs);
+            row("Commit: ", commit_allocs);
+            row("Response: ", response_allocs);
+            row("Verify: ", verify_allocs);
+        }
     }
 };
 
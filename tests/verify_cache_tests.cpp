@@ -0,0 +1,145 @@
+#include "test_utils.hpp"
+#include "protocol/verify_cache.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace test {
+
+// Repeated transcripts hit, verdicts match verify(), and the digest follows
+// every input
+void test_verify_cache() {
+    std::cout << "\nTest: Verification Cache\n";
+
+    protocol::Parameters params(32, 128, NTL::conv<NTL::ZZ>("1073741789"), 10, 1, 10.0, 1.5, 8, 15);
+    protocol::LatticeProof proof(params);
+    protocol::VerifyCache cache(64, 4);
+
+    protocol::Transcript honest{proof.commit(), {}, {}};
+    honest.challenge = protocol::LatticeProof::generate_challenge(params.m());
+    honest.z = proof.respond(honest.challenge);
+    protocol::Transcript tampered = honest;
+    tampered.z[0] += 1;
+
+    for (int round = 0; round < 3; round++) {
+        assert(protocol::verify_cached(proof, cache, honest) && "Cached honest transcript rejected");
+        assert(!protocol::verify_cached(proof, cache, tampered) && "Cached tampered transcript accepted");
+    }
+    protocol::VerifyCacheStats stats = cache.stats();
+    assert(stats.misses == 2 && stats.hits == 4 && stats.insertions == 2);
+    assert(cache.size() == 2);
+
+    // z + q agrees mod q but not in the norm check, so it is a new submission;
+    // so is a changed challenge
+    protocol::Transcript wrapped = honest;
+    wrapped.z[1] += params.q();
+    assert(protocol::transcript_digest(proof, wrapped) != protocol::transcript_digest(proof, honest));
+    assert(protocol::verify_cached(proof, cache, wrapped) == proof.verify(wrapped.u, wrapped.challenge, wrapped.z));
+    protocol::Transcript rechallenged = honest;
+    rechallenged.challenge[0] = rechallenged.challenge[0] == 0 ? 1 : 0;
+    assert(protocol::transcript_digest(proof, rechallenged) != protocol::transcript_digest(proof, honest));
+
+    // Same transcript under another key
+    protocol::LatticeProof other(params);
+    assert(protocol::transcript_digest(other, honest) != protocol::transcript_digest(proof, honest));
+
+    // Non-interactive proofs
+    protocol::NonInteractiveProof ni = proof.prove();
+    assert(protocol::verify_cached(proof, cache, ni) && protocol::verify_cached(proof, cache, ni));
+
+    // Malformed input throws and is not cached
+    protocol::Transcript shortened = honest;
+    shortened.z.SetLength(params.m() - 1);
+    const size_t before = cache.size();
+    try {
+        protocol::verify_cached(proof, cache, shortened);
+        assert(false && "Malformed transcript did not throw");
+    } catch (const std::invalid_argument&) {
+    }
+    assert(cache.size() == before && "Malformed transcript was cached");
+
+    cache.clear();
+    assert(cache.size() == 0 && cache.stats().hits == stats.hits + 1);
+    std::cout << "✓ Verification cache test passed\n";
+}
+
+// Capacity holds under churn, and CLOCK keeps an entry that keeps hitting
+void test_verify_cache_eviction() {
+    std::cout << "\nTest: Verification Cache Eviction\n";
+
+    protocol::VerifyCache cache(8, 1);
+    protocol::TranscriptDigest hot{};
+    hot[31] = 0xff;
+    cache.insert(hot, true);
+
+    bool accepted = false;
+    for (int k = 0; k < 100; k++) {
+        assert(cache.lookup(hot, accepted) && accepted && "Referenced entry was evicted");
+        protocol::TranscriptDigest key{};
+        key[0] = static_cast<uint8_t>(k);
+        cache.insert(key, k % 2 == 0);
+        assert(cache.size() <= cache.capacity());
+    }
+    assert(cache.size() == 8);
+    assert(cache.stats().evictions == 101 - 8);
+
+    // Recent cold entries remain, old ones are gone
+    protocol::TranscriptDigest key{};
+    key[0] = 99;
+    assert(cache.lookup(key, accepted) && !accepted);
+    key[0] = 0;
+    assert(!cache.lookup(key, accepted));
+
+    try {
+        protocol::VerifyCache bad(0);
+        assert(false && "Verify cache accepted zero capacity");
+    } catch (const std::invalid_argument&) {
+    }
+    std::cout << "✓ Verification cache eviction test passed\n";
+}
+
+// Several verifying threads replay the same submissions through one cache
+void test_verify_cache_concurrent() {
+    std::cout << "\nTest: Concurrent Verification Cache\n";
+
+    protocol::Parameters params(32, 128, NTL::conv<NTL::ZZ>("1073741789"), 10, 1, 10.0, 1.5, 8, 15);
+    protocol::LatticeProof proof(params);
+    std::vector<protocol::NonInteractiveProof> proofs;
+    for (int k = 0; k < 16; k++) {
+        proofs.push_back(proof.prove());
+    }
+
+    protocol::VerifyCache cache(1024);
+    std::atomic<int> rejected{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t] {
+            NTL::ZZ_pPush push(params.q());
+            for (int round = 0; round < 20; round++) {
+                for (size_t k = 0; k < proofs.size(); k++) {
+                    if (!protocol::verify_cached(proof, cache, proofs[(k + t) % proofs.size()])) {
+                        rejected++;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    protocol::VerifyCacheStats stats = cache.stats();
+    assert(rejected == 0 && "Cached verification rejected an honest proof");
+    assert(cache.size() == proofs.size());
+    assert(stats.hits + stats.misses == 4 * 20 * proofs.size());
+    std::cout << "  Hit rate: " << stats.hit_rate() << "\n";
+    std::cout << "✓ Concurrent verification cache test passed\n";
+}
+
+void run_verify_cache_tests() {
+    test_verify_cache();
+    test_verify_cache_eviction();
+    test_verify_cache_concurrent();
+}
+
+} // namespace test
@@ -0,0 +1,165 @@
+#include "test_utils.hpp"
+#include "protocol/workspace.hpp"
+#include <array>
+#include <memory_resource>
+#include <vector>
+
+namespace test {
+
+namespace {
+
+protocol::AllocCounters total_allocations() {
+    protocol::AllocCounters total;
+    for (int p = 0; p < protocol::kAllocPhases; p++) {
+        auto c = protocol::alloc_counters(static_cast<protocol::AllocPhase>(p));
+        total.allocations += c.allocations;
+        total.bytes_allocated += c.bytes_allocated;
+    }
+    return total;
+}
+
+NTL::vec_ZZ to_vec(const std::vector<int8_t>& c) {
+    NTL::vec_ZZ v;
+    v.SetLength(c.size());
+    for (size_t j = 0; j < c.size(); j++) {
+        v[j] = c[j];
+    }
+    return v;
+}
+
+// z as residues mod q, the form respond() sends
+NTL::vec_ZZ to_residues(const std::vector<int32_t>& z, const NTL::ZZ& q) {
+    NTL::vec_ZZ v;
+    v.SetLength(z.size());
+    for (size_t j = 0; j < z.size(); j++) {
+        v[j] = z[j] < 0 ? q + z[j] : NTL::ZZ(z[j]);
+    }
+    return v;
+}
+
+} // namespace
+
+// After one warm-up round, commit/respond/verify into caller buffers touch
+// the heap zero times, in every allocation phase
+void test_workspace_allocation_free() {
+    std::cout << "\nTest: Allocation-Free Workspace Rounds\n";
+    assert(protocol::alloc_hook_installed() && "Test binary should link the allocation hook");
+
+    protocol::Parameters params(64, 128, NTL::conv<NTL::ZZ>("1073741789"));
+    protocol::LatticeProof proof(params);
+    protocol::Workspace ws(params);
+    std::vector<uint32_t> u(params.n());
+    std::vector<int8_t> c(params.m());
+    std::vector<int32_t> z(params.m());
+
+    auto round = [&] {
+        proof.commit(ws, u);
+        protocol::LatticeProof::generate_challenge(c);
+        proof.respond(ws, c, z);
+        return proof.verify(ws, u, c, z);
+    };
+    assert(round() && "Warm-up round rejected");
+
+    const int rounds = 100;
+    auto before = total_allocations();
+    int accepted = 0;
+    for (int r = 0; r < rounds; r++) {
+        accepted += round() ? 1 : 0;
+    }
+    auto delta = total_allocations() - before;
+    assert(accepted == rounds && "Honest workspace transcript rejected");
+    assert(delta.allocations == 0 && "Workspace rounds allocated");
+    std::cout << "  " << rounds << " rounds, " << delta.allocations << " allocations\n";
+
+    // The workspace can sit entirely in a fixed arena
+    std::array<std::byte, 8192> arena;
+    std::pmr::monotonic_buffer_resource pool(arena.data(), arena.size(),
+                                             std::pmr::null_memory_resource());
+    protocol::Workspace pooled(params, &pool);
+    proof.commit(pooled, u);
+    proof.respond(pooled, c, z);
+    assert(proof.verify(pooled, u, c, z) && "Arena-backed workspace rejected");
+
+    std::cout << "✓ Allocation-free workspace test passed\n";
+}
+
+// The span overloads agree with the NTL ones on the same transcripts
+void test_workspace_matches_ntl() {
+    std::cout << "\nTest: Workspace Verdicts Match NTL API\n";
+
+    protocol::Parameters params(32, 128, NTL::conv<NTL::ZZ>("1073741789"), 10, 1, 10.0, 1.5, 8);
+    protocol::LatticeProof proof(params);
+    protocol::Workspace ws(params);
+    std::vector<uint32_t> u(params.n());
+    std::vector<int8_t> c(params.m());
+    std::vector<int32_t> z(params.m());
+
+    for (int r = 0; r < 10; r++) {
+        proof.commit(ws, u);
+        protocol::LatticeProof::generate_challenge(c);
+        proof.respond(ws, c, z);
+        NTL::vec_ZZ_p u_ntl = protocol::from_native(u.data(), params.n());
+        NTL::vec_ZZ z_ntl = to_residues(z, params.q());
+        assert(proof.verify(ws, u, c, z) && proof.verify(u_ntl, to_vec(c), z_ntl));
+
+        // Dense and sparse transcripts with a broken commitment
+        u[r % params.n()] ^= 1;
+        assert(!proof.verify(ws, u, c, z) && "Tampered commitment accepted");
+        u[r % params.n()] ^= 1;
+
+        auto sparse = protocol::LatticeProof::generate_sparse_challenge(params.m(), params.challenge_weight());
+        proof.respond(ws, sparse, z);
+        z_ntl = to_residues(z, params.q());
+        assert(proof.verify(ws, u, sparse, z) && proof.verify(u_ntl, sparse, z_ntl));
+        z[0] += 1;
+        assert(!proof.verify(ws, u, sparse, z) && "Tampered response accepted");
+    }
+
+    // Early-abort responses disarm the mask either way
+    protocol::Parameters rs = protocol::Parameters::RejectionSamplingParams(
+        32, 128, NTL::conv<NTL::ZZ>("1073741789"));
+    protocol::LatticeProof rs_proof(rs);
+    protocol::Workspace rs_ws(rs);
+    int accepted = 0;
+    while (accepted < 5) {
+        rs_proof.commit(rs_ws, u);
+        protocol::LatticeProof::generate_challenge(c);
+        if (rs_proof.try_respond(rs_ws, c, z)) {
+            assert(rs_proof.verify(rs_ws, u, c, z) && "Accepted early-abort response rejected");
+            accepted++;
+        }
+        assert(!rs_ws.has_commitment());
+    }
+    assert(rs_ws.rejection_stats().accepted == 5 && rs_ws.rejection_stats().attempts >= 5);
+
+    // Misuse is reported, not silently computed
+    try {
+        protocol::Workspace small(protocol::Parameters(16, 64, params.q()));
+        proof.respond(small, c, z);
+        assert(false && "Workspace for other parameters accepted");
+    } catch (const std::invalid_argument&) {
+    }
+    try {
+        rs_proof.respond(rs_ws, c, z);
+        assert(false && "respond() without a commitment accepted");
+    } catch (const std::logic_error&) {
+    }
+    try {
+        protocol::Parameters wide(16, 32, NTL::conv<NTL::ZZ>("8589934609"));
+        protocol::LatticeProof wide_proof(wide);
+        protocol::Workspace wide_ws(wide);
+        std::vector<uint32_t> wide_u(wide.n());
+        wide_proof.commit(wide_ws, wide_u);
+        assert(false && "Span overloads accepted a modulus above 2^32");
+    } catch (const std::invalid_argument&) {
+    }
+
+    std::cout << "✓ Workspace verdict test passed\n";
+}
+
+void run_workspace_tests() {
+    test_workspace_allocation_free();
+    test_workspace_matches_ntl();
+}
+
+} // namespace test
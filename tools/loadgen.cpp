@@ -0,0 +1,300 @@
+#include "protocol/lattice_proof.hpp"
+#include "protocol/tuner.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace protocol;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    long n = 512;
+    long m = 512;
+    NTL::ZZ q = NTL::conv<NTL::ZZ>("1073741789");
+    unsigned provers = 1;
+    unsigned verifiers = 0;      // 0 = provers verify their own transcripts
+    double seconds = 5.0;
+    double rate = 0.0;           // total arrivals per second; 0 = closed loop
+    unsigned scale = 0;          // run the 1..scale thread scaling sweep instead
+};
+
+void usage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " [options]\n"
+              << "  --shape <n> <m> <q>   parameter set (default 512 512 1073741789)\n"
+              << "  --provers <k>         prover threads (default 1)\n"
+              << "  --verifiers <k>       verifier threads; 0 verifies inline (default 0)\n"
+              << "  --seconds <t>         run time (default 5)\n"
+              << "  --rate <r>            open loop at r proofs/s in total; 0 = closed loop\n"
+              << "  --scale <k>           closed-loop scaling sweep over 1, 2, 4, ... k threads\n";
+}
+
+bool parse(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto need = [&](int count) { return i + count < argc; };
+        if (arg == "--shape" && need(3)) {
+            opt.n = std::stol(argv[++i]);
+            opt.m = std::stol(argv[++i]);
+            opt.q = NTL::conv<NTL::ZZ>(static_cast<const char*>(argv[++i]));
+        } else if (arg == "--provers" && need(1)) {
+            opt.provers = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--verifiers" && need(1)) {
+            opt.verifiers = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--seconds" && need(1)) {
+            opt.seconds = std::stod(argv[++i]);
+        } else if (arg == "--rate" && need(1)) {
+            opt.rate = std::stod(argv[++i]);
+        } else if (arg == "--scale" && need(1)) {
+            opt.scale = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else {
+            return false;
+        }
+    }
+    return opt.provers > 0 && opt.seconds > 0 && opt.rate >= 0;
+}
+
+// Latency samples in nanoseconds, one vector per phase
+struct Samples {
+    std::vector<int64_t> commit, respond, verify, end_to_end;
+
+    void append(const Samples& other) {
+        commit.insert(commit.end(), other.commit.begin(), other.commit.end());
+        respond.insert(respond.end(), other.respond.begin(), other.respond.end());
+        verify.insert(verify.end(), other.verify.begin(), other.verify.end());
+        end_to_end.insert(end_to_end.end(), other.end_to_end.begin(), other.end_to_end.end());
+    }
+};
+
+int64_t since(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+double percentile(std::vector<int64_t>& v, double p) {
+    if (v.empty()) return 0;
+    size_t k = std::min(v.size() - 1, static_cast<size_t>(p * v.size()));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k] / 1e3;
+}
+
+void print_latency(const char* label, std::vector<int64_t>& v) {
+    std::cout << "  " << std::left << std::setw(11) << label << std::right << std::fixed
+              << std::setprecision(1)
+              << std::setw(10) << percentile(v, 0.50)
+              << std::setw(10) << percentile(v, 0.99)
+              << std::setw(10) << percentile(v, 0.999)
+              << std::setw(10) << (v.empty() ? 0.0 : *std::max_element(v.begin(), v.end()) / 1e3)
+              << "\n";
+}
+
+// Transcript handed from a prover to the verifier pool
+struct Job {
+    Transcript t;
+    Clock::time_point arrival;
+};
+
+// Bounded multi-producer, multi-consumer queue
+class JobQueue {
+public:
+    explicit JobQueue(size_t capacity) : capacity_(capacity) {}
+
+    void push(Job job) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [&] { return jobs_.size() < capacity_; });
+        jobs_.push_back(std::move(job));
+        not_empty_.notify_one();
+    }
+    bool pop(Job& job) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [&] { return !jobs_.empty() || closed_; });
+        if (jobs_.empty()) return false;
+        job = std::move(jobs_.front());
+        jobs_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable not_empty_, not_full_;
+    std::deque<Job> jobs_;
+    size_t capacity_;
+    bool closed_ = false;
+};
+
+struct RunResult {
+    uint64_t proofs = 0;
+    uint64_t rejected = 0;
+    double seconds = 0;
+    Samples samples;
+};
+
+// Provers share one key, each restoring a private LatticeProof from it since
+// commitment state is per session; verifiers share one read-only instance
+RunResult run(const Parameters& params, const std::vector<uint8_t>& key,
+              const LatticeProof& verifier, unsigned provers, unsigned verifiers,
+              double seconds, double rate) {
+    JobQueue queue(4 * std::max(1u, verifiers));
+    std::mutex merge_mutex;
+    RunResult result;
+    std::atomic<uint64_t> rejected(0);
+
+    const auto start = Clock::now();
+    const auto deadline = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(seconds));
+
+    auto check = [&](const Transcript& t, Samples& samples) {
+        auto begin = Clock::now();
+        bool valid = verifier.verify(t.u, t.challenge, t.z);
+        samples.verify.push_back(since(begin));
+        if (!valid) rejected++;
+    };
+
+    // Each prover and verifier is one worker: kernels inside stay serial
+    auto prover = [&](unsigned self) {
+        SerialKernelScope serial;
+        NTL::ZZ_pContext(params.q()).restore();
+        ByteReader reader(key.data(), key.size());
+        Parameters key_params = read_key_parameters(reader);
+        LatticeProof proof(key_params, reader);
+
+        // Open loop: arrivals are scheduled, and latency counts from the
+        // scheduled time so a stalled prover cannot hide its backlog
+        const double interval = rate > 0 ? provers / rate : 0;
+        const auto offset = std::chrono::duration<double>(interval * self / provers);
+        Samples samples;
+        for (uint64_t k = 0;; k++) {
+            auto arrival = Clock::now();
+            if (rate > 0) {
+                arrival = start + std::chrono::duration_cast<Clock::duration>(
+                    offset + std::chrono::duration<double>(interval * k));
+                std::this_thread::sleep_until(arrival);
+            }
+            if (arrival >= deadline) break;
+
+            Job job;
+            job.arrival = arrival;
+            auto begin = Clock::now();
+            job.t.u = proof.commit();
+            samples.commit.push_back(since(begin));
+            job.t.challenge = LatticeProof::generate_challenge(params.m());
+            begin = Clock::now();
+            job.t.z = proof.respond(job.t.challenge);
+            samples.respond.push_back(since(begin));
+
+            if (verifiers == 0) {
+                check(job.t, samples);
+                samples.end_to_end.push_back(since(arrival));
+            } else {
+                queue.push(std::move(job));
+            }
+        }
+        std::lock_guard<std::mutex> lock(merge_mutex);
+        result.samples.append(samples);
+    };
+
+    auto verifier_loop = [&]() {
+        SerialKernelScope serial;
+        NTL::ZZ_pContext(params.q()).restore();
+        Samples samples;
+        Job job;
+        while (queue.pop(job)) {
+            check(job.t, samples);
+            samples.end_to_end.push_back(since(job.arrival));
+        }
+        std::lock_guard<std::mutex> lock(merge_mutex);
+        result.samples.append(samples);
+    };
+
+    std::vector<std::thread> verifier_pool, prover_pool;
+    for (unsigned t = 0; t < verifiers; t++) verifier_pool.emplace_back(verifier_loop);
+    for (unsigned t = 0; t < provers; t++) prover_pool.emplace_back(prover, t);
+    for (auto& t : prover_pool) t.join();
+    queue.close();
+    for (auto& t : verifier_pool) t.join();
+
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.proofs = result.samples.verify.size();
+    result.rejected = rejected;
+    return result;
+}
+
+} // namespace
+
+// Drive provers and verifiers against one shared key and report sustained
+// throughput, per-phase tail latency and multi-core scaling
+int main(int argc, char** argv) {
+    Options opt;
+    try {
+        if (!parse(argc, argv, opt)) {
+            usage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception&) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        // Measure with the plans lattice_zkp_tune recorded for this host
+        set_autotune(autotune_mode_from_env(AutotuneMode::Cached));
+        Parameters params(opt.n, opt.m, opt.q);
+        LatticeProof verifier(params);
+        ByteWriter key;
+        verifier.save_key(key);
+
+        std::cout << params.toString()
+                  << "Hardware threads: " << std::thread::hardware_concurrency() << "\n";
+
+        if (opt.scale > 0) {
+            std::cout << "\nClosed-loop scaling (inline verification, "
+                      << opt.seconds << " s per step):\n"
+                      << "  threads   proofs/s  efficiency\n";
+            double base = 0;
+            for (unsigned threads = 1; threads <= opt.scale; threads *= 2) {
+                RunResult r = run(params, key.bytes(), verifier, threads, 0, opt.seconds, 0);
+                double throughput = r.proofs / r.seconds;
+                if (threads == 1) base = throughput;
+                std::cout << "  " << std::setw(7) << threads << std::setw(11) << std::fixed
+                          << std::setprecision(1) << throughput << std::setw(11)
+                          << std::setprecision(2) << throughput / (threads * base) << "\n";
+            }
+            return 0;
+        }
+
+        std::cout << "\n" << opt.provers << " prover(s), "
+                  << (opt.verifiers ? std::to_string(opt.verifiers) + " verifier(s)" : "inline verification")
+                  << ", " << (opt.rate > 0 ? "open loop at " + std::to_string(opt.rate) + " proofs/s"
+                                           : std::string("closed loop"))
+                  << ", " << opt.seconds << " s\n";
+        RunResult r = run(params, key.bytes(), verifier, opt.provers, opt.verifiers, opt.seconds, opt.rate);
+
+        std::cout << "\nThroughput: " << std::fixed << std::setprecision(1)
+                  << r.proofs / r.seconds << " proofs/s (" << r.proofs << " proofs, "
+                  << r.rejected << " rejected)\n"
+                  << "\nLatency (us)      p50       p99      p999       max\n";
+        print_latency("commit", r.samples.commit);
+        print_latency("respond", r.samples.respond);
+        print_latency("verify", r.samples.verify);
+        print_latency("end-to-end", r.samples.end_to_end);
+        return r.rejected == 0 ? 0 : 2;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
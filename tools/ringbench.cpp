@@ -0,0 +1,360 @@
+#include "protocol/lattice_proof.hpp"
+#include "protocol/ring.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace protocol;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const uint32_t kPing = 100;
+
+// One end of a prover-verifier connection carrying the ring's wire format
+class Link {
+public:
+    virtual ~Link() = default;
+    virtual void send_commitment(const NTL::vec_ZZ_p& u) = 0;
+    virtual void send_challenge(const NTL::vec_ZZ& c) = 0;
+    virtual void send_response(const NTL::vec_ZZ& z) = 0;
+    virtual void send_verdict(bool accepted) = 0;
+    virtual void receive_commitment(NTL::vec_ZZ_p& u) = 0;
+    virtual void receive_challenge(NTL::vec_ZZ& c) = 0;
+    virtual void receive_response(NTL::vec_ZZ& z) = 0;
+    virtual void receive_verdict(bool& accepted) = 0;
+    virtual void send_ping(size_t len) = 0;
+    virtual void receive_ping() = 0;
+};
+
+void require(bool ok) {
+    if (!ok) throw std::runtime_error("Connection closed");
+}
+
+// Shared-memory rings, one per direction; messages are packed in place
+class RingLink : public Link {
+public:
+    RingLink(const std::string& out, const std::string& in) : out_(out), in_(in) {}
+
+    void send_commitment(const NTL::vec_ZZ_p& u) override { protocol::send_commitment(out_, u); }
+    void send_challenge(const NTL::vec_ZZ& c) override { protocol::send_challenge(out_, c); }
+    void send_response(const NTL::vec_ZZ& z) override { protocol::send_response(out_, z); }
+    void send_verdict(bool accepted) override { protocol::send_verdict(out_, accepted); }
+    void receive_commitment(NTL::vec_ZZ_p& u) override { require(protocol::receive_commitment(in_, u)); }
+    void receive_challenge(NTL::vec_ZZ& c) override { require(protocol::receive_challenge(in_, c)); }
+    void receive_response(NTL::vec_ZZ& z) override { require(protocol::receive_response(in_, z)); }
+    void receive_verdict(bool& accepted) override { require(protocol::receive_verdict(in_, accepted)); }
+    void send_ping(size_t len) override {
+        std::fill_n(out_.begin_write(kPing, len), len, 0x5a);
+        out_.end_write();
+    }
+    void receive_ping() override {
+        RingRecord record;
+        require(in_.read(record));
+        in_.release();
+    }
+
+private:
+    ShmRing out_;
+    ShmRing in_;
+};
+
+// Stream socket with [u32 type][u32 length][payload] frames, the same payload
+// bytes as the ring, serialized through a buffer as a socket stack must
+class SocketLink : public Link {
+public:
+    explicit SocketLink(int fd) : fd_(fd) {}
+    ~SocketLink() override { ::close(fd_); }
+
+    void send_commitment(const NTL::vec_ZZ_p& u) override {
+        const long width = NTL::NumBytes(NTL::ZZ_p::modulus());
+        std::vector<uint8_t>& out = frame(static_cast<uint32_t>(RingMessage::Commitment), u.length() * width);
+        for (long i = 0; i < u.length(); i++) {
+            NTL::BytesFromZZ(out.data() + 8 + i * width, rep(u[i]), width);
+        }
+        flush();
+    }
+    void send_challenge(const NTL::vec_ZZ& c) override {
+        std::vector<uint8_t>& out = frame(static_cast<uint32_t>(RingMessage::Challenge), c.length());
+        for (long j = 0; j < c.length(); j++) {
+            out[8 + j] = static_cast<uint8_t>(static_cast<int8_t>(NTL::conv<long>(c[j])));
+        }
+        flush();
+    }
+    void send_response(const NTL::vec_ZZ& z) override {
+        const NTL::ZZ& q = NTL::ZZ_p::modulus();
+        const long width = NTL::NumBytes(q);
+        std::vector<uint8_t>& out = frame(static_cast<uint32_t>(RingMessage::Response), z.length() * width);
+        for (long j = 0; j < z.length(); j++) {
+            NTL::BytesFromZZ(out.data() + 8 + j * width, z[j] % q, width);
+        }
+        flush();
+    }
+    void send_verdict(bool accepted) override {
+        frame(static_cast<uint32_t>(RingMessage::Verdict), 1)[8] = accepted ? 1 : 0;
+        flush();
+    }
+    void receive_commitment(NTL::vec_ZZ_p& u) override {
+        const long width = NTL::NumBytes(NTL::ZZ_p::modulus());
+        receive(RingMessage::Commitment);
+        u.SetLength(static_cast<long>(in_.size()) / width);
+        for (long i = 0; i < u.length(); i++) {
+            u[i] = NTL::conv<NTL::ZZ_p>(NTL::ZZFromBytes(in_.data() + i * width, width));
+        }
+    }
+    void receive_challenge(NTL::vec_ZZ& c) override {
+        receive(RingMessage::Challenge);
+        c.SetLength(static_cast<long>(in_.size()));
+        for (long j = 0; j < c.length(); j++) {
+            c[j] = static_cast<long>(static_cast<int8_t>(in_[j]));
+        }
+    }
+    void receive_response(NTL::vec_ZZ& z) override {
+        const NTL::ZZ& q = NTL::ZZ_p::modulus();
+        const long width = NTL::NumBytes(q);
+        receive(RingMessage::Response);
+        z.SetLength(static_cast<long>(in_.size()) / width);
+        for (long j = 0; j < z.length(); j++) {
+            z[j] = NTL::ZZFromBytes(in_.data() + j * width, width);
+            if (z[j] > q / 2) z[j] -= q;
+        }
+    }
+    void receive_verdict(bool& accepted) override {
+        receive(RingMessage::Verdict);
+        accepted = in_.size() == 1 && in_[0] == 1;
+    }
+    void send_ping(size_t len) override {
+        std::vector<uint8_t>& out = frame(kPing, len);
+        std::fill(out.begin() + 8, out.end(), 0x5a);
+        flush();
+    }
+    void receive_ping() override {
+        read_frame();
+    }
+
+private:
+    std::vector<uint8_t>& frame(uint32_t type, size_t len) {
+        out_.assign(8 + len, 0);
+        uint32_t header[2] = {type, static_cast<uint32_t>(len)};
+        std::memcpy(out_.data(), header, sizeof(header));
+        return out_;
+    }
+    void flush() {
+        for (size_t done = 0; done < out_.size();) {
+            ssize_t n = ::write(fd_, out_.data() + done, out_.size() - done);
+            require(n > 0);
+            done += static_cast<size_t>(n);
+        }
+    }
+    void read_exact(uint8_t* p, size_t len) {
+        for (size_t done = 0; done < len;) {
+            ssize_t n = ::read(fd_, p + done, len - done);
+            require(n > 0);
+            done += static_cast<size_t>(n);
+        }
+    }
+    uint32_t read_frame() {
+        uint32_t header[2];
+        read_exact(reinterpret_cast<uint8_t*>(header), sizeof(header));
+        in_.resize(header[1]);
+        read_exact(in_.data(), in_.size());
+        return header[0];
+    }
+    void receive(RingMessage type) {
+        if (read_frame() != static_cast<uint32_t>(type)) {
+            throw std::runtime_error("Unexpected message type");
+        }
+    }
+
+    int fd_;
+    std::vector<uint8_t> out_, in_;
+};
+
+double percentile(std::vector<int64_t>& v, double p) {
+    size_t k = std::min(v.size() - 1, static_cast<size_t>(p * v.size()));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k] / 1e3;
+}
+
+void print_latency(const std::string& label, std::vector<int64_t>& v) {
+    std::cout << "  " << std::left << std::setw(16) << label << std::right << std::fixed
+              << std::setprecision(1)
+              << std::setw(10) << percentile(v, 0.50)
+              << std::setw(10) << percentile(v, 0.99)
+              << std::setw(10) << percentile(v, 0.999)
+              << std::setw(10) << *std::max_element(v.begin(), v.end()) / 1e3 << "\n";
+}
+
+// Verifier side: echo pings, then answer protocol rounds
+void serve(Link& link, const LatticeProof& proof, long ping_bytes, long rounds) {
+    for (long r = 0; r < rounds; r++) {
+        link.receive_ping();
+        link.send_ping(ping_bytes);
+    }
+    NTL::vec_ZZ_p u;
+    NTL::vec_ZZ z;
+    for (long r = 0; r < rounds; r++) {
+        link.receive_commitment(u);
+        NTL::vec_ZZ c = LatticeProof::generate_challenge(proof.parameters().m());
+        link.send_challenge(c);
+        link.receive_response(z);
+        link.send_verdict(proof.verify(u, c, z));
+    }
+}
+
+// Prover side: ping round trips, then full commit/challenge/respond/verify rounds
+void drive(const std::string& label, Link& link, LatticeProof& proof, long ping_bytes, long rounds) {
+    std::vector<int64_t> ping, round;
+    for (long r = 0; r < rounds; r++) {
+        auto start = Clock::now();
+        link.send_ping(ping_bytes);
+        link.receive_ping();
+        ping.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+    long rejected = 0;
+    for (long r = 0; r < rounds; r++) {
+        auto start = Clock::now();
+        link.send_commitment(proof.commit());
+        NTL::vec_ZZ c;
+        link.receive_challenge(c);
+        link.send_response(proof.respond(c));
+        bool accepted = false;
+        link.receive_verdict(accepted);
+        round.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        rejected += accepted ? 0 : 1;
+    }
+    print_latency(label + " ping", ping);
+    print_latency(label + " round", round);
+    if (rejected) {
+        std::cout << "  (" << rejected << " rounds rejected)\n";
+    }
+}
+
+// Runs serve() in a forked child over the link that make_link builds on each
+// side, then reaps it; the child never returns
+template <class MakeLink>
+void run(const std::string& label, LatticeProof& proof, long ping_bytes, long rounds, MakeLink make_link) {
+    pid_t child = fork();
+    if (child < 0) {
+        throw std::runtime_error("fork failed");
+    }
+    if (child == 0) {
+        int status = 0;
+        try {
+            std::unique_ptr<Link> link = make_link(false);
+            serve(*link, proof, ping_bytes, rounds);
+        } catch (const std::exception& e) {
+            std::cerr << "Verifier: " << e.what() << std::endl;
+            status = 1;
+        }
+        _exit(status);
+    }
+    {
+        std::unique_ptr<Link> link = make_link(true);
+        drive(label, *link, proof, ping_bytes, rounds);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        throw std::runtime_error(label + " verifier process failed");
+    }
+}
+
+} // namespace
+
+// Round-trip latency of prover-verifier messaging between two processes over
+// shared-memory rings, a Unix socket pair and loopback TCP
+int main(int argc, char** argv) {
+    long n = 64, m = 128, rounds = 5000;
+    NTL::ZZ q = NTL::conv<NTL::ZZ>("1073741789");
+    std::string only;
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--shape" && i + 3 < argc) {
+                n = std::stol(argv[++i]);
+                m = std::stol(argv[++i]);
+                q = NTL::conv<NTL::ZZ>(static_cast<const char*>(argv[++i]));
+            } else if (arg == "--rounds" && i + 1 < argc) {
+                rounds = std::stol(argv[++i]);
+            } else if (arg == "--transport" && i + 1 < argc) {
+                only = argv[++i];
+            } else {
+                throw std::invalid_argument(arg);
+            }
+        }
+        if (rounds <= 0) throw std::invalid_argument("rounds");
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--shape <n> <m> <q>] [--rounds <k>] [--transport ring|unix|tcp]\n";
+        return 1;
+    }
+
+    try {
+        Parameters params(n, m, q);
+        LatticeProof proof(params);
+        const long ping_bytes = m * NTL::NumBytes(q);
+        std::cout << params.toString() << "Ping payload: " << ping_bytes << " bytes, "
+                  << rounds << " rounds\n\nLatency (us)          p50       p99      p999       max\n";
+
+        if (only.empty() || only == "ring") {
+            const std::string base = "/lattice_zkp_bench_" + std::to_string(getpid());
+            ShmRing a(base + "_a", 1 << 20), b(base + "_b", 1 << 20);
+            run("ring", proof, ping_bytes, rounds, [&](bool prover) {
+                return std::unique_ptr<Link>(prover ? new RingLink(base + "_a", base + "_b")
+                                                    : new RingLink(base + "_b", base + "_a"));
+            });
+        }
+        if (only.empty() || only == "unix") {
+            int fds[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+                throw std::runtime_error("socketpair failed");
+            }
+            run("unix", proof, ping_bytes, rounds, [&](bool prover) {
+                ::close(fds[prover ? 1 : 0]);
+                return std::unique_ptr<Link>(new SocketLink(fds[prover ? 0 : 1]));
+            });
+        }
+        if (only.empty() || only == "tcp") {
+            int listener = socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            socklen_t len = sizeof(addr);
+            if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&addr), len) != 0 ||
+                listen(listener, 1) != 0 ||
+                getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+                throw std::runtime_error("Cannot listen on loopback");
+            }
+            run("tcp", proof, ping_bytes, rounds, [&](bool prover) {
+                int fd = prover ? accept(listener, nullptr, nullptr) : socket(AF_INET, SOCK_STREAM, 0);
+                if (!prover && connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+                    fd = -1;
+                }
+                if (fd < 0) {
+                    throw std::runtime_error("Cannot connect over loopback");
+                }
+                int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                ::close(listener);
+                return std::unique_ptr<Link>(new SocketLink(fd));
+            });
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,69 @@
+#include "protocol/parameters.hpp"
+#include "protocol/tuner.hpp"
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace protocol;
+
+// Benchmark the native matvec kernels for each shape and record the winners
+// in the kernel plan cache read by LatticeProof
+int main(int argc, char** argv) {
+    std::string cache_path = default_kernel_cache_path();
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (args.size() >= 2 && args[0] == "--cache") {
+        cache_path = args[1];
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    if (args.size() % 3 != 0) {
+        std::cerr << "Usage: " << argv[0] << " [--cache <file>] [<n> <m> <q>]...\n"
+                  << "With no shapes, tunes the default and high-security parameter sets.\n";
+        return 1;
+    }
+
+    try {
+        struct Shape { long n; long m; NTL::ZZ q; };
+        std::vector<Shape> shapes;
+        for (size_t i = 0; i < args.size(); i += 3) {
+            shapes.push_back({std::stol(args[i]), std::stol(args[i + 1]), NTL::conv<NTL::ZZ>(args[i + 2].c_str())});
+        }
+        if (shapes.empty()) {
+            for (const Parameters& p : {Parameters::DefaultParams(), Parameters::HighSecurityParams()}) {
+                shapes.push_back({p.n(), p.m(), p.q()});
+            }
+        }
+
+        const std::string cpu = cpu_model();
+        std::cout << "CPU: " << cpu << "\n";
+        KernelPlanCache cache;
+        cache.load(cache_path);
+
+        for (const auto& shape : shapes) {
+            TuningResult result = tune_kernels(shape.n, shape.m, shape.q);
+            std::cout << "\nn=" << shape.n << ", m=" << shape.m
+                      << ", q bits=" << NTL::NumBits(shape.q) << "\n";
+            for (const auto& [name, seconds] : result.timings) {
+                std::cout << "  " << std::left << std::setw(14) << name
+                          << std::right << std::setw(12) << std::fixed << std::setprecision(2)
+                          << seconds * 1e6 << " us/vector\n";
+            }
+            std::cout << "  Plan: " << kernel_name(result.plan.kernel);
+            if (result.plan.kernel == MatvecKernel::Threaded) {
+                std::cout << " x" << result.plan.threads;
+            }
+            std::cout << ", batch " << result.plan.batch << "\n";
+            cache.store(cpu, shape.n, shape.m, NTL::NumBits(shape.q), result.plan);
+        }
+
+        if (!cache.save(cache_path)) {
+            std::cerr << "Error: cannot write " << cache_path << std::endl;
+            return 1;
+        }
+        std::cout << "\nWrote " << cache.size() << " plans to " << cache_path << "\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}